@@ -0,0 +1,55 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/brave_shields/shields_settings_snapshot_service_factory.h"
+
+#include "brave/components/brave_shields/browser/shields_settings_snapshot.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/browser/profiles/incognito_helpers.h"
+#include "chrome/browser/profiles/profile.h"
+#include "components/keyed_service/content/browser_context_dependency_manager.h"
+
+namespace brave_shields {
+
+// static
+ShieldsSettingsSnapshotService*
+ShieldsSettingsSnapshotServiceFactory::GetForBrowserContext(
+    content::BrowserContext* context) {
+  return static_cast<ShieldsSettingsSnapshotService*>(
+      GetInstance()->GetServiceForBrowserContext(context,
+                                                 /*create_service=*/true));
+}
+
+// static
+ShieldsSettingsSnapshotServiceFactory*
+ShieldsSettingsSnapshotServiceFactory::GetInstance() {
+  return base::Singleton<ShieldsSettingsSnapshotServiceFactory>::get();
+}
+
+ShieldsSettingsSnapshotServiceFactory::ShieldsSettingsSnapshotServiceFactory()
+    : BrowserContextKeyedServiceFactory(
+          "ShieldsSettingsSnapshotService",
+          BrowserContextDependencyManager::GetInstance()) {
+  DependsOn(HostContentSettingsMapFactory::GetInstance());
+}
+
+ShieldsSettingsSnapshotServiceFactory::
+    ~ShieldsSettingsSnapshotServiceFactory() = default;
+
+KeyedService* ShieldsSettingsSnapshotServiceFactory::BuildServiceInstanceFor(
+    content::BrowserContext* context) const {
+  return new ShieldsSettingsSnapshotService(
+      HostContentSettingsMapFactory::GetForProfile(
+          Profile::FromBrowserContext(context)));
+}
+
+// Off the record profiles have their own content settings.
+content::BrowserContext*
+ShieldsSettingsSnapshotServiceFactory::GetBrowserContextToUse(
+    content::BrowserContext* context) const {
+  return chrome::GetBrowserContextOwnInstanceInIncognito(context);
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,42 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_BRAVE_SHIELDS_SHIELDS_SETTINGS_SNAPSHOT_SERVICE_FACTORY_H_
+#define BRAVE_BROWSER_BRAVE_SHIELDS_SHIELDS_SETTINGS_SNAPSHOT_SERVICE_FACTORY_H_
+
+#include "base/memory/singleton.h"
+#include "components/keyed_service/content/browser_context_keyed_service_factory.h"
+
+namespace brave_shields {
+
+class ShieldsSettingsSnapshotService;
+
+class ShieldsSettingsSnapshotServiceFactory
+    : public BrowserContextKeyedServiceFactory {
+ public:
+  static ShieldsSettingsSnapshotService* GetForBrowserContext(
+      content::BrowserContext* context);
+
+  static ShieldsSettingsSnapshotServiceFactory* GetInstance();
+
+ private:
+  friend struct base::DefaultSingletonTraits<
+      ShieldsSettingsSnapshotServiceFactory>;
+
+  ShieldsSettingsSnapshotServiceFactory();
+  ~ShieldsSettingsSnapshotServiceFactory() override;
+
+  // BrowserContextKeyedServiceFactory:
+  KeyedService* BuildServiceInstanceFor(
+      content::BrowserContext* context) const override;
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override;
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldsSettingsSnapshotServiceFactory);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_BROWSER_BRAVE_SHIELDS_SHIELDS_SETTINGS_SNAPSHOT_SERVICE_FACTORY_H_
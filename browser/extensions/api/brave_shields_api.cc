@@ -17,6 +17,7 @@
 #include "brave/common/extensions/api/brave_shields.h"
 #include "brave/components/brave_shields/browser/ad_block_custom_filters_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/brave_shields_p3a.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
@@ -68,15 +69,11 @@ BraveShieldsUrlCosmeticResourcesFunction::Run() {
 std::unique_ptr<base::ListValue>
 BraveShieldsUrlCosmeticResourcesFunction::GetUrlCosmeticResourcesOnTaskRunner(
     const std::string& url) {
-  absl::optional<base::Value> resources =
+  ::brave_shields::CosmeticResources resources =
       g_brave_browser_process->ad_block_service()->UrlCosmeticResources(url);
 
-  if (!resources || !resources->is_dict()) {
-    return std::unique_ptr<base::ListValue>();
-  }
-
   auto result_list = std::make_unique<base::ListValue>();
-  result_list->Append(std::move(*resources));
+  result_list->Append(resources.ToValue());
   return result_list;
 }
 
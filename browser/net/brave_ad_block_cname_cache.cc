@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <memory>
+
+#include "base/metrics/histogram_macros.h"
+#include "base/time/default_tick_clock.h"
+#include "content/public/browser/browser_context.h"
+
+namespace brave {
+
+namespace {
+
+constexpr size_t kMaxEntries = 256;
+constexpr base::TimeDelta kEntryLifetime = base::TimeDelta::FromMinutes(1);
+
+const char kAdBlockCnameCacheKey[] = "brave_ad_block_cname_cache";
+
+}  // namespace
+
+AdBlockCnameCache::AdBlockCnameCache()
+    : entries_(kMaxEntries),
+      tick_clock_(base::DefaultTickClock::GetInstance()) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+AdBlockCnameCache::~AdBlockCnameCache() = default;
+
+// static
+AdBlockCnameCache* AdBlockCnameCache::GetForBrowserContext(
+    content::BrowserContext* browser_context) {
+  DCHECK(browser_context);
+  AdBlockCnameCache* cache = static_cast<AdBlockCnameCache*>(
+      browser_context->GetUserData(kAdBlockCnameCacheKey));
+  if (!cache) {
+    // Object cleanup is handled by SupportsUserData
+    browser_context->SetUserData(kAdBlockCnameCacheKey,
+                                 std::make_unique<AdBlockCnameCache>());
+    cache = static_cast<AdBlockCnameCache*>(
+        browser_context->GetUserData(kAdBlockCnameCacheKey));
+  }
+  return cache;
+}
+
+bool AdBlockCnameCache::Lookup(
+    const net::NetworkIsolationKey& network_isolation_key,
+    const std::string& host,
+    absl::optional<std::string>* cname) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  bool hit = false;
+  auto it = entries_.Get(Key(network_isolation_key, host));
+  if (it != entries_.end()) {
+    if (it->second.expiration > tick_clock_->NowTicks()) {
+      *cname = it->second.cname;
+      hit = true;
+    } else {
+      entries_.Erase(it);
+    }
+  }
+  UMA_HISTOGRAM_BOOLEAN("Brave.ShieldsCNAMEBlocking.CacheHit", hit);
+  return hit;
+}
+
+bool AdBlockCnameCache::AddPendingLookup(
+    const net::NetworkIsolationKey& network_isolation_key,
+    const std::string& host,
+    CnameCallback callback) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  std::vector<CnameCallback>& callbacks =
+      pending_lookups_[Key(network_isolation_key, host)];
+  callbacks.push_back(std::move(callback));
+  return callbacks.size() == 1;
+}
+
+void AdBlockCnameCache::OnResolved(
+    const net::NetworkIsolationKey& network_isolation_key,
+    const std::string& host,
+    absl::optional<std::string> cname) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const Key key(network_isolation_key, host);
+  // Failures are not remembered, the next request simply tries again. The
+  // requests already waiting get no CNAME and are only checked against their
+  // original URL.
+  if (cname) {
+    entries_.Put(key,
+                 Entry{*cname, tick_clock_->NowTicks() + kEntryLifetime});
+  }
+
+  auto it = pending_lookups_.find(key);
+  if (it == pending_lookups_.end())
+    return;
+  std::vector<CnameCallback> callbacks = std::move(it->second);
+  pending_lookups_.erase(it);
+  for (auto& callback : callbacks)
+    std::move(callback).Run(cname);
+}
+
+void AdBlockCnameCache::Clear() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  entries_.Clear();
+  weak_ptr_factory_.InvalidateWeakPtrs();
+
+  std::map<Key, std::vector<CnameCallback>> pending_lookups;
+  pending_lookups.swap(pending_lookups_);
+  for (auto& pending_lookup : pending_lookups) {
+    for (auto& callback : pending_lookup.second)
+      std::move(callback).Run(absl::nullopt);
+  }
+}
+
+base::WeakPtr<AdBlockCnameCache> AdBlockCnameCache::GetWeakPtr() {
+  return weak_ptr_factory_.GetWeakPtr();
+}
+
+void AdBlockCnameCache::SetTickClockForTesting(
+    const base::TickClock* tick_clock) {
+  tick_clock_ = tick_clock;
+}
+
+}  // namespace brave
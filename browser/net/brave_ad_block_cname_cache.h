@@ -0,0 +1,106 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+#define BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/supports_user_data.h"
+#include "base/time/time.h"
+#include "net/base/network_isolation_key.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace base {
+class TickClock;
+}  // namespace base
+
+namespace content {
+class BrowserContext;
+}  // namespace content
+
+namespace brave {
+
+// Remembers the canonical names that CNAME uncloaking has resolved, per
+// NetworkIsolationKey, so that requests to a host that was already uncloaked
+// don't need another round trip to the network service. Lookups for a host
+// that is still being resolved are queued behind the lookup in flight.
+//
+// There is one cache per BrowserContext, destroyed along with it, so names
+// resolved in one profile are never visible to another, off-the-record ones
+// included.
+//
+// ResolveHost doesn't report record TTLs, so entries live for a short fixed
+// time instead.
+//
+// Must only be used on the UI thread.
+class AdBlockCnameCache : public base::SupportsUserData::Data {
+ public:
+  using CnameCallback =
+      base::OnceCallback<void(absl::optional<std::string> cname)>;
+
+  AdBlockCnameCache();
+  ~AdBlockCnameCache() override;
+
+  static AdBlockCnameCache* GetForBrowserContext(
+      content::BrowserContext* browser_context);
+
+  // Returns true and sets `cname` if a live entry exists for `host`.
+  bool Lookup(const net::NetworkIsolationKey& network_isolation_key,
+              const std::string& host,
+              absl::optional<std::string>* cname);
+
+  // Queues `callback` until `host` is resolved. Returns true if there was no
+  // lookup in flight for `host`, in which case the caller must start one and
+  // report its result through `OnResolved`.
+  bool AddPendingLookup(const net::NetworkIsolationKey& network_isolation_key,
+                        const std::string& host,
+                        CnameCallback callback);
+
+  // Stores a successful result and runs every callback queued for `host`.
+  // They all get the same result, so if the lookup failed none of them gets a
+  // CNAME; the failure isn't stored and the next lookup for `host` retries.
+  void OnResolved(const net::NetworkIsolationKey& network_isolation_key,
+                  const std::string& host,
+                  absl::optional<std::string> cname);
+
+  // Drops all entries. Queued callbacks run without a result, and lookups
+  // still in flight no longer report back.
+  void Clear();
+
+  base::WeakPtr<AdBlockCnameCache> GetWeakPtr();
+
+  void SetTickClockForTesting(const base::TickClock* tick_clock);
+
+ private:
+  using Key = std::pair<net::NetworkIsolationKey, std::string>;
+
+  struct Entry {
+    std::string cname;
+    base::TimeTicks expiration;
+  };
+
+  base::MRUCache<Key, Entry> entries_;
+  std::map<Key, std::vector<CnameCallback>> pending_lookups_;
+  const base::TickClock* tick_clock_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<AdBlockCnameCache> weak_ptr_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockCnameCache);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
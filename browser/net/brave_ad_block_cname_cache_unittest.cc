@@ -0,0 +1,125 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/test/simple_test_tick_clock.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave {
+
+namespace {
+
+void StoreResult(std::vector<absl::optional<std::string>>* results,
+                 absl::optional<std::string> cname) {
+  results->push_back(std::move(cname));
+}
+
+}  // namespace
+
+class AdBlockCnameCacheTest : public testing::Test {
+ public:
+  AdBlockCnameCacheTest() { cache_.SetTickClockForTesting(&clock_); }
+
+ protected:
+  base::SimpleTestTickClock clock_;
+  AdBlockCnameCache cache_;
+  net::NetworkIsolationKey key_;
+};
+
+TEST_F(AdBlockCnameCacheTest, ResolvedNameIsCached) {
+  absl::optional<std::string> cname;
+  EXPECT_FALSE(cache_.Lookup(key_, "a.example.com", &cname));
+
+  cache_.OnResolved(key_, "a.example.com", std::string("tracker.net"));
+  ASSERT_TRUE(cache_.Lookup(key_, "a.example.com", &cname));
+  EXPECT_EQ("tracker.net", *cname);
+  EXPECT_FALSE(cache_.Lookup(key_, "b.example.com", &cname));
+}
+
+TEST_F(AdBlockCnameCacheTest, EntriesExpire) {
+  cache_.OnResolved(key_, "a.example.com", std::string("tracker.net"));
+  clock_.Advance(base::TimeDelta::FromMinutes(2));
+  absl::optional<std::string> cname;
+  EXPECT_FALSE(cache_.Lookup(key_, "a.example.com", &cname));
+}
+
+TEST_F(AdBlockCnameCacheTest, FailuresAreNotCached) {
+  cache_.OnResolved(key_, "a.example.com", absl::nullopt);
+  absl::optional<std::string> cname;
+  EXPECT_FALSE(cache_.Lookup(key_, "a.example.com", &cname));
+}
+
+TEST_F(AdBlockCnameCacheTest, ConcurrentLookupsAreCoalesced) {
+  std::vector<absl::optional<std::string>> results;
+  EXPECT_TRUE(cache_.AddPendingLookup(key_, "a.example.com",
+                                      base::BindOnce(&StoreResult, &results)));
+  EXPECT_FALSE(cache_.AddPendingLookup(
+      key_, "a.example.com", base::BindOnce(&StoreResult, &results)));
+  EXPECT_TRUE(cache_.AddPendingLookup(key_, "b.example.com",
+                                      base::BindOnce(&StoreResult, &results)));
+
+  cache_.OnResolved(key_, "a.example.com", std::string("tracker.net"));
+  ASSERT_EQ(2u, results.size());
+  EXPECT_EQ("tracker.net", *results[0]);
+  EXPECT_EQ("tracker.net", *results[1]);
+
+  cache_.OnResolved(key_, "b.example.com", absl::nullopt);
+  ASSERT_EQ(3u, results.size());
+  EXPECT_FALSE(results[2].has_value());
+
+  // Nothing is pending any more, so the next lookup starts a new resolve.
+  EXPECT_TRUE(cache_.AddPendingLookup(key_, "b.example.com",
+                                      base::BindOnce(&StoreResult, &results)));
+}
+
+TEST_F(AdBlockCnameCacheTest, FailureReachesEveryWaiter) {
+  std::vector<absl::optional<std::string>> results;
+  EXPECT_TRUE(cache_.AddPendingLookup(key_, "a.example.com",
+                                      base::BindOnce(&StoreResult, &results)));
+  EXPECT_FALSE(cache_.AddPendingLookup(
+      key_, "a.example.com", base::BindOnce(&StoreResult, &results)));
+
+  cache_.OnResolved(key_, "a.example.com", absl::nullopt);
+  ASSERT_EQ(2u, results.size());
+  EXPECT_FALSE(results[0].has_value());
+  EXPECT_FALSE(results[1].has_value());
+
+  // The failure isn't remembered, so the next request resolves again.
+  absl::optional<std::string> cname;
+  EXPECT_FALSE(cache_.Lookup(key_, "a.example.com", &cname));
+  EXPECT_TRUE(cache_.AddPendingLookup(key_, "a.example.com",
+                                      base::BindOnce(&StoreResult, &results)));
+}
+
+TEST_F(AdBlockCnameCacheTest, ClearDropsEntries) {
+  cache_.OnResolved(key_, "a.example.com", std::string("tracker.net"));
+  cache_.Clear();
+  absl::optional<std::string> cname;
+  EXPECT_FALSE(cache_.Lookup(key_, "a.example.com", &cname));
+}
+
+TEST_F(AdBlockCnameCacheTest, ClearFailsPendingLookups) {
+  std::vector<absl::optional<std::string>> results;
+  EXPECT_TRUE(cache_.AddPendingLookup(key_, "a.example.com",
+                                      base::BindOnce(&StoreResult, &results)));
+  base::WeakPtr<AdBlockCnameCache> weak_cache = cache_.GetWeakPtr();
+
+  cache_.Clear();
+  ASSERT_EQ(1u, results.size());
+  EXPECT_FALSE(results[0].has_value());
+  // Lookups started before the clear must not report back into it.
+  EXPECT_FALSE(weak_cache);
+
+  EXPECT_TRUE(cache_.AddPendingLookup(key_, "a.example.com",
+                                      base::BindOnce(&StoreResult, &results)));
+}
+
+}  // namespace brave
@@ -15,6 +15,7 @@
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_browser_process.h"
 #include "brave/browser/brave_shields/brave_shields_web_contents_observer.h"
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
 #include "brave/common/url_constants.h"
@@ -68,22 +69,23 @@ void UseCnameResult(scoped_refptr<base::SequencedTaskRunner> task_runner,
                     EngineFlags previous_result,
                     absl::optional<std::string> cname);
 
+// Resolves the host of a request and hands the canonical name to
+// `AdBlockCnameCache`, which passes it on to every request waiting for it.
 class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
  private:
   mojo::Receiver<network::mojom::ResolveHostClient> receiver_{this};
-  base::OnceCallback<void(absl::optional<std::string>)> cb_;
+  base::WeakPtr<AdBlockCnameCache> cache_;
+  net::NetworkIsolationKey network_isolation_key_;
+  std::string host_;
   base::TimeTicks start_time_;
 
  public:
-  AdblockCnameResolveHostClient(
-      const ResponseCallback& next_callback,
-      scoped_refptr<base::SequencedTaskRunner> task_runner,
-      std::shared_ptr<BraveRequestInfo> ctx,
-      EngineFlags previous_result) {
+  AdblockCnameResolveHostClient(base::WeakPtr<AdBlockCnameCache> cache,
+                                std::shared_ptr<BraveRequestInfo> ctx)
+      : cache_(std::move(cache)),
+        network_isolation_key_(ctx->network_isolation_key),
+        host_(ctx->request_url.host()) {
     DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-    cb_ = base::BindOnce(&UseCnameResult, task_runner, std::move(next_callback),
-                         ctx, previous_result);
-
     const auto network_isolation_key = ctx->network_isolation_key;
 
     network::mojom::ResolveHostParametersPtr optional_parameters =
@@ -137,13 +139,14 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
       const absl::optional<net::AddressList>& resolved_addresses) override {
     UMA_HISTOGRAM_TIMES("Brave.ShieldsCNAMEBlocking.TotalResolutionTime",
                         base::TimeTicks::Now() - start_time_);
+    absl::optional<std::string> cname;
     if (result == net::OK && resolved_addresses) {
       DCHECK(resolved_addresses.has_value() && !resolved_addresses->empty());
-      std::move(cb_).Run(
-          absl::optional<std::string>(resolved_addresses->GetCanonicalName()));
-    } else {
-      std::move(cb_).Run(absl::nullopt);
+      cname = resolved_addresses->GetCanonicalName();
     }
+    // The cache is gone if the profile was destroyed in the meantime.
+    if (cache_)
+      cache_->OnResolved(network_isolation_key_, host_, std::move(cname));
 
     delete this;
   }
@@ -159,6 +162,29 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
   }
 };
 
+// Runs `callback` with the canonical name of the request host, from
+// `AdBlockCnameCache` if it is known or being resolved already, otherwise
+// once a new lookup completes.
+void ResolveCname(std::shared_ptr<BraveRequestInfo> ctx,
+                  AdBlockCnameCache::CnameCallback callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  AdBlockCnameCache* cache =
+      AdBlockCnameCache::GetForBrowserContext(ctx->browser_context);
+  const std::string host = ctx->request_url.host();
+
+  absl::optional<std::string> cname;
+  if (cache->Lookup(ctx->network_isolation_key, host, &cname)) {
+    std::move(callback).Run(std::move(cname));
+    return;
+  }
+
+  if (cache->AddPendingLookup(ctx->network_isolation_key, host,
+                              std::move(callback))) {
+    // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
+    new AdblockCnameResolveHostClient(cache->GetWeakPtr(), ctx);
+  }
+}
+
 // If `canonical_url` is specified, this will only check if the CNAME-uncloaked
 // response should be blocked. Otherwise, it will run the check for the
 // original request URL.
@@ -210,9 +236,8 @@ void OnShouldBlockRequestResult(
     brave_shields::BraveShieldsWebContentsObserver::DispatchBlockedEvent(
         ctx->request_url, ctx->frame_tree_node_id, brave_shields::kAds);
   } else if (then_check_uncloaked) {
-    // This will be deleted by `AdblockCnameResolveHostClient::OnComplete`.
-    new AdblockCnameResolveHostClient(std::move(next_callback), task_runner,
-                                      ctx, result);
+    ResolveCname(ctx, base::BindOnce(&UseCnameResult, task_runner,
+                                     next_callback, ctx, result));
     return;
   }
   next_callback.Run();
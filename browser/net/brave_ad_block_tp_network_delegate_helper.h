@@ -22,6 +22,8 @@ int OnBeforeURLRequest_AdBlockTPPreWork(
 
 // Be sure to reset this to `nullptr` when done testing to prevent future tests
 // from being affected.
+// Names a profile has already resolved stay in its `AdBlockCnameCache`; tests
+// that need them resolved again should clear that cache.
 void SetAdblockCnameHostResolverForTesting(
     network::HostResolver* host_resolver);
 
@@ -316,6 +316,32 @@ void TestUrlCosmetics() {
   assert(bad_b_resources == bad_b_result);
 }
 
+void TestStructuredUrlCosmetics() {
+  adblock::Engine engine(
+      "b.com##.ads\n"
+      "##.block\n"
+      "b.com#@#.block\n"
+      "b.*##div:style(background: #fff)\n"
+      "b.*##div:style(color: #000)\n");
+
+  adblock::CosmeticResources b_resources =
+      engine.urlCosmeticResourcesStructured("https://b.com");
+  assert(b_resources.hide_selectors.size() == 1);
+  assert(b_resources.hide_selectors[0] == ".ads");
+  assert(b_resources.style_selectors.size() == 1);
+  assert(b_resources.style_selectors["div"].size() == 2);
+  assert(b_resources.exceptions.size() == 1);
+  assert(b_resources.exceptions[0] == ".block");
+  assert(b_resources.injected_script.empty());
+  assert(!b_resources.generichide);
+
+  adblock::CosmeticResources bad_b_resources =
+      engine.urlCosmeticResourcesStructured("b.com");
+  assert(bad_b_resources.hide_selectors.empty());
+  assert(bad_b_resources.style_selectors.empty());
+  assert(bad_b_resources.exceptions.empty());
+}
+
 void TestSubdomainUrlCosmetics() {
   adblock::Engine engine(
       "a.co.uk##.element\n"
@@ -435,6 +461,7 @@ int main() {
   TestException();
   TestClassId();
   TestUrlCosmetics();
+  TestStructuredUrlCosmetics();
   TestSubdomainUrlCosmetics();
   TestGenerichide();
   TestCosmeticScriptletResources();
@@ -16,6 +16,24 @@
  */
 typedef struct C_Engine C_Engine;
 
+/**
+ * Cosmetic filtering resources specific to a url, with every collection
+ * flattened into arrays of C strings. Style selectors are stored as parallel
+ * arrays of (selector, style) pairs, so a selector with several styles
+ * appears once per style.
+ */
+typedef struct C_CosmeticResources {
+  char** hide_selectors;
+  size_t hide_selectors_size;
+  char** style_selectors;
+  char** style_selector_styles;
+  size_t style_selectors_size;
+  char** exceptions;
+  size_t exceptions_size;
+  char* injected_script;
+  bool generichide;
+} C_CosmeticResources;
+
 /**
  * An external callback that receives a hostname and two out-parameters for
  * start and end position. The callback should fill the start and end positions
@@ -120,6 +138,19 @@ void c_char_buffer_destroy(char* s);
  */
 char* engine_url_cosmetic_resources(struct C_Engine* engine, const char* url);
 
+/**
+ * Returns the set of cosmetic filtering resources specific to the given url,
+ * without going through JSON. Free it with `cosmetic_resources_destroy`.
+ */
+struct C_CosmeticResources* engine_url_cosmetic_resources_structured(
+    struct C_Engine* engine,
+    const char* url);
+
+/**
+ * Destroy a `CosmeticResources` once you are done with it.
+ */
+void cosmetic_resources_destroy(struct C_CosmeticResources* resources);
+
 /**
  * Returns a stylesheet containing all generic cosmetic rules that begin with
  * any of the provided class and id selectors
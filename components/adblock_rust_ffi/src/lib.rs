@@ -259,6 +259,136 @@ pub unsafe extern "C" fn engine_url_cosmetic_resources(
     ptr
 }
 
+/// Cosmetic filtering resources specific to a url, with every collection
+/// flattened into arrays of C strings. Style selectors are stored as parallel
+/// arrays of (selector, style) pairs, so a selector with several styles
+/// appears once per style.
+#[repr(C)]
+pub struct CosmeticResources {
+    hide_selectors: *mut *mut c_char,
+    hide_selectors_size: size_t,
+    style_selectors: *mut *mut c_char,
+    style_selector_styles: *mut *mut c_char,
+    style_selectors_size: size_t,
+    exceptions: *mut *mut c_char,
+    exceptions_size: size_t,
+    injected_script: *mut c_char,
+    generichide: bool,
+}
+
+/// Whether a string can be passed on as a C string. Cosmetic resources come
+/// from filter lists, so one containing a NUL byte is skipped rather than
+/// truncated or replaced with an empty selector.
+fn is_c_string_safe(s: &str) -> bool {
+    if s.as_bytes().contains(&0) {
+        eprintln!("Skipping cosmetic resource containing a NUL byte");
+        return false;
+    }
+    true
+}
+
+fn string_array_into_raw<I: Iterator<Item = String>>(
+    strings: I,
+    size: &mut size_t,
+) -> *mut *mut c_char {
+    let raw: Box<[*mut c_char]> = strings
+        .filter(|s| is_c_string_safe(s))
+        .map(|s| CString::new(s).unwrap().into_raw())
+        .collect::<Vec<_>>()
+        .into_boxed_slice();
+    *size = raw.len();
+    Box::into_raw(raw) as *mut *mut c_char
+}
+
+unsafe fn string_array_destroy(strings: *mut *mut c_char, size: size_t) {
+    if strings.is_null() {
+        return;
+    }
+    let raw = Box::from_raw(ptr::slice_from_raw_parts_mut(strings, size));
+    for s in raw.iter() {
+        drop(CString::from_raw(*s));
+    }
+}
+
+/// Returns the set of cosmetic filtering resources specific to the given url,
+/// without going through JSON. Free it with `cosmetic_resources_destroy`.
+#[no_mangle]
+pub unsafe extern "C" fn engine_url_cosmetic_resources_structured(
+    engine: *mut Engine,
+    url: *const c_char,
+) -> *mut CosmeticResources {
+    let url = CStr::from_ptr(url).to_str().unwrap();
+    assert!(!engine.is_null());
+    let engine = Box::leak(Box::from_raw(engine));
+    let resources = engine.url_cosmetic_resources(url);
+
+    let mut hide_selectors_size: size_t = 0;
+    let hide_selectors = string_array_into_raw(
+        resources.hide_selectors.into_iter(),
+        &mut hide_selectors_size,
+    );
+
+    // Pairs are filtered here, before being split, so that the two arrays
+    // stay parallel.
+    let mut style_pairs: Vec<(String, String)> = Vec::new();
+    for (selector, styles) in resources.style_selectors.into_iter() {
+        if !is_c_string_safe(&selector) {
+            continue;
+        }
+        for style in styles.into_iter() {
+            if is_c_string_safe(&style) {
+                style_pairs.push((selector.clone(), style));
+            }
+        }
+    }
+    let mut style_selectors_size: size_t = 0;
+    let style_selectors = string_array_into_raw(
+        style_pairs.iter().map(|(selector, _)| selector.clone()),
+        &mut style_selectors_size,
+    );
+    let style_selector_styles = string_array_into_raw(
+        style_pairs.into_iter().map(|(_, style)| style),
+        &mut style_selectors_size,
+    );
+
+    let mut exceptions_size: size_t = 0;
+    let exceptions = string_array_into_raw(resources.exceptions.into_iter(), &mut exceptions_size);
+
+    Box::into_raw(Box::new(CosmeticResources {
+        hide_selectors,
+        hide_selectors_size,
+        style_selectors,
+        style_selector_styles,
+        style_selectors_size,
+        exceptions,
+        exceptions_size,
+        injected_script: CString::new(resources.injected_script)
+            .unwrap_or_else(|_| {
+                eprintln!("Skipping injected script containing a NUL byte");
+                CString::default()
+            })
+            .into_raw(),
+        generichide: resources.generichide,
+    }))
+}
+
+/// Destroy a `CosmeticResources` once you are done with it.
+#[no_mangle]
+pub unsafe extern "C" fn cosmetic_resources_destroy(resources: *mut CosmeticResources) {
+    if resources.is_null() {
+        return;
+    }
+    let resources = Box::from_raw(resources);
+    string_array_destroy(resources.hide_selectors, resources.hide_selectors_size);
+    string_array_destroy(resources.style_selectors, resources.style_selectors_size);
+    string_array_destroy(
+        resources.style_selector_styles,
+        resources.style_selectors_size,
+    );
+    string_array_destroy(resources.exceptions, resources.exceptions_size);
+    c_char_buffer_destroy(resources.injected_script);
+}
+
 /// Returns a stylesheet containing all generic cosmetic rules that begin with any of the provided class and id selectors
 ///
 /// The leading '.' or '#' character should not be provided
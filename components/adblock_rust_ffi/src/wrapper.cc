@@ -40,6 +40,12 @@ FilterList::FilterList(const FilterList& other) = default;
 
 FilterList::~FilterList() {}
 
+CosmeticResources::CosmeticResources() {}
+
+CosmeticResources::CosmeticResources(CosmeticResources&& other) = default;
+
+CosmeticResources::~CosmeticResources() {}
+
 Engine::Engine() : raw(engine_create("")) {}
 
 Engine::Engine(const std::string& rules) : raw(engine_create(rules.c_str())) {}
@@ -116,6 +122,31 @@ const std::string Engine::urlCosmeticResources(const std::string& url) {
   return resources_json;
 }
 
+CosmeticResources Engine::urlCosmeticResourcesStructured(
+    const std::string& url) {
+  C_CosmeticResources* resources_raw =
+      engine_url_cosmetic_resources_structured(raw, url.c_str());
+
+  CosmeticResources resources;
+  resources.hide_selectors.reserve(resources_raw->hide_selectors_size);
+  for (size_t i = 0; i < resources_raw->hide_selectors_size; i++) {
+    resources.hide_selectors.push_back(resources_raw->hide_selectors[i]);
+  }
+  for (size_t i = 0; i < resources_raw->style_selectors_size; i++) {
+    resources.style_selectors[resources_raw->style_selectors[i]].push_back(
+        resources_raw->style_selector_styles[i]);
+  }
+  resources.exceptions.reserve(resources_raw->exceptions_size);
+  for (size_t i = 0; i < resources_raw->exceptions_size; i++) {
+    resources.exceptions.push_back(resources_raw->exceptions[i]);
+  }
+  resources.injected_script = resources_raw->injected_script;
+  resources.generichide = resources_raw->generichide;
+
+  cosmetic_resources_destroy(resources_raw);
+  return resources;
+}
+
 const std::string Engine::hiddenClassIdSelectors(
     const std::vector<std::string>& classes,
     const std::vector<std::string>& ids,
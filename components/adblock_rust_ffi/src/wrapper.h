@@ -5,6 +5,7 @@
 
 #ifndef BRAVE_COMPONENTS_ADBLOCK_RUST_FFI_SRC_WRAPPER_H_
 #define BRAVE_COMPONENTS_ADBLOCK_RUST_FFI_SRC_WRAPPER_H_
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -64,6 +65,18 @@ class ADBLOCK_EXPORT FilterList {
   static std::vector<FilterList> regional_list;
 };
 
+struct ADBLOCK_EXPORT CosmeticResources {
+  CosmeticResources();
+  CosmeticResources(CosmeticResources&& other);
+  ~CosmeticResources();
+
+  std::vector<std::string> hide_selectors;
+  std::map<std::string, std::vector<std::string>> style_selectors;
+  std::vector<std::string> exceptions;
+  std::string injected_script;
+  bool generichide = false;
+};
+
 class ADBLOCK_EXPORT Engine {
  public:
   Engine();
@@ -92,6 +105,7 @@ class ADBLOCK_EXPORT Engine {
   void removeTag(const std::string& tag);
   bool tagExists(const std::string& tag);
   const std::string urlCosmeticResources(const std::string& url);
+  CosmeticResources urlCosmeticResourcesStructured(const std::string& url);
   const std::string hiddenClassIdSelectors(
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
@@ -6,6 +6,7 @@
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
 
 #include <algorithm>
+#include <atomic>
 #include <set>
 #include <string>
 #include <utility>
@@ -34,6 +35,8 @@ using namespace net::registry_controlled_domains;  // NOLINT
 
 namespace {
 
+std::atomic<uint64_t> g_engine_generation{0};
+
 std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
   std::string filter_option = "";
   switch (resource_type) {
@@ -104,6 +107,24 @@ std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
 
 namespace brave_shields {
 
+AdBlockRequestQuery::AdBlockRequestQuery(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host)
+    : url(url.spec()),
+      host(url.host()),
+      tab_host(tab_host),
+      // Determine third-party here so the library doesn't need to figure it
+      // out. CreateFromNormalizedTuple is needed because SameDomainOrHost
+      // needs a URL or origin and not a string to a host name.
+      is_third_party(!SameDomainOrHost(
+          url,
+          url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
+          INCLUDE_PRIVATE_REGISTRIES)),
+      resource_type(ResourceTypeToString(resource_type)) {}
+
+AdBlockRequestQuery::~AdBlockRequestQuery() = default;
+
 AdBlockBaseService::AdBlockBaseService(BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
       ad_block_client_(new adblock::Engine()),
@@ -122,26 +143,21 @@ void AdBlockBaseService::ShouldStartRequest(
     bool* did_match_exception,
     bool* did_match_important,
     std::string* mock_data_url) {
-  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
-  // if (!IsInitialized())
-  //   return;
-
-  // Determine third-party here so the library doesn't need to figure it out.
-  // CreateFromNormalizedTuple is needed because SameDomainOrHost needs
-  // a URL or origin and not a string to a host name.
-  bool is_third_party = !SameDomainOrHost(
-      url,
-      url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
-      INCLUDE_PRIVATE_REGISTRIES);
-  ad_block_client_->matches(
-      url.spec(), url.host(), tab_host, is_third_party,
-      ResourceTypeToString(resource_type), did_match_rule,
-      did_match_exception, did_match_important, mock_data_url);
+  MatchRequest(AdBlockRequestQuery(url, resource_type, tab_host),
+               did_match_rule, did_match_exception, did_match_important,
+               mock_data_url);
+}
 
-  // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: "
-  //  << tab_host
-  //  << ", resource type: " << resource_type
-  //  << ", url.spec(): " << url.spec();
+void AdBlockBaseService::MatchRequest(const AdBlockRequestQuery& query,
+                                      bool* did_match_rule,
+                                      bool* did_match_exception,
+                                      bool* did_match_important,
+                                      std::string* mock_data_url) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  ad_block_client_->matches(query.url, query.host, query.tab_host,
+                            query.is_third_party, query.resource_type,
+                            did_match_rule, did_match_exception,
+                            did_match_important, mock_data_url);
 }
 
 absl::optional<std::string> AdBlockBaseService::GetCspDirectives(
@@ -189,6 +205,7 @@ void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
       tags_.erase(it);
     }
   }
+  IncrementEngineGeneration();
 }
 
 void AdBlockBaseService::AddResources(const std::string& resources) {
@@ -201,19 +218,31 @@ void AdBlockBaseService::AddResources(const std::string& resources) {
 
   ad_block_client_->addResources(resources);
   resources_ = resources;
+  IncrementEngineGeneration();
 }
 
 bool AdBlockBaseService::TagExists(const std::string& tag) {
   return std::find(tags_.begin(), tags_.end(), tag) != tags_.end();
 }
 
-absl::optional<base::Value> AdBlockBaseService::UrlCosmeticResources(
+// static
+uint64_t AdBlockBaseService::GetEngineGeneration() {
+  return g_engine_generation.load(std::memory_order_acquire);
+}
+
+// static
+void AdBlockBaseService::IncrementEngineGeneration() {
+  g_engine_generation.fetch_add(1, std::memory_order_acq_rel);
+}
+
+CosmeticResources AdBlockBaseService::UrlCosmeticResources(
     const std::string& url) {
   // if (!IsInitialized())
   //   return;
 
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
-  return base::JSONReader::Read(ad_block_client_->urlCosmeticResources(url));
+  return CosmeticResources(
+      ad_block_client_->urlCosmeticResourcesStructured(url));
 }
 
 absl::optional<base::Value> AdBlockBaseService::HiddenClassIdSelectors(
@@ -266,6 +295,7 @@ void AdBlockBaseService::UpdateAdBlockClient(
   ad_block_client_ = std::move(ad_block_client);
   AddKnownTagsToAdBlockInstance();
   AddKnownResourcesToAdBlockInstance();
+  IncrementEngineGeneration();
 }
 
 void AdBlockBaseService::AddKnownTagsToAdBlockInstance() {
@@ -293,6 +323,7 @@ void AdBlockBaseService::ResetForTest(const std::string& rules,
     resources_ = resources;
   }
   AddKnownResourcesToAdBlockInstance();
+  IncrementEngineGeneration();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
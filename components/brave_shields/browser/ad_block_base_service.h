@@ -15,12 +15,15 @@
 #include <vector>
 
 #include "base/files/file_path.h"
+#include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "base/sequence_checker.h"
 #include "base/values.h"
 #include "brave/components/brave_component_updater/browser/dat_file_util.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
+#include "url/gurl.h"
 
 class AdBlockServiceTest;
 class BraveAdBlockTPNetworkDelegateHelperTest;
@@ -33,6 +36,24 @@ class Engine;
 
 namespace brave_shields {
 
+// The engine inputs for a single network request. These are the same for
+// every filter list, so they are computed once per request and shared by all
+// engines the request is checked against.
+struct AdBlockRequestQuery {
+  AdBlockRequestQuery(const GURL& url,
+                      blink::mojom::ResourceType resource_type,
+                      const std::string& tab_host);
+  ~AdBlockRequestQuery();
+
+  const std::string url;
+  const std::string host;
+  const std::string tab_host;
+  const bool is_third_party;
+  const std::string resource_type;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockRequestQuery);
+};
+
 // The base class of the brave shields service in charge of ad-block
 // checking and init.
 class AdBlockBaseService : public BaseBraveShieldsService {
@@ -51,6 +72,12 @@ class AdBlockBaseService : public BaseBraveShieldsService {
                           bool* did_match_exception,
                           bool* did_match_important,
                           std::string* mock_data_url) override;
+  // Checks an already-prepared request against this engine only.
+  void MatchRequest(const AdBlockRequestQuery& query,
+                    bool* did_match_rule,
+                    bool* did_match_exception,
+                    bool* did_match_important,
+                    std::string* mock_data_url);
   absl::optional<std::string> GetCspDirectives(
       const GURL& url,
       blink::mojom::ResourceType resource_type,
@@ -59,8 +86,12 @@ class AdBlockBaseService : public BaseBraveShieldsService {
   void EnableTag(const std::string& tag, bool enabled);
   bool TagExists(const std::string& tag);
 
-  virtual absl::optional<base::Value> UrlCosmeticResources(
-      const std::string& url);
+  virtual CosmeticResources UrlCosmeticResources(const std::string& url);
+
+  // Incremented whenever the rules, tags or resources of any engine change,
+  // so results computed from an older set of engines can be told apart.
+  static uint64_t GetEngineGeneration();
+  static void IncrementEngineGeneration();
   virtual absl::optional<base::Value> HiddenClassIdSelectors(
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
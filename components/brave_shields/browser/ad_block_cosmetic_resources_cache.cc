@@ -0,0 +1,60 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources_cache.h"
+
+#include "base/metrics/histogram_macros.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+AdBlockCosmeticResourcesCache::AdBlockCosmeticResourcesCache(size_t max_size)
+    : entries_(max_size) {}
+
+AdBlockCosmeticResourcesCache::~AdBlockCosmeticResourcesCache() = default;
+
+absl::optional<CosmeticResources> AdBlockCosmeticResourcesCache::Get(
+    const std::string& url,
+    uint64_t generation) {
+  absl::optional<CosmeticResources> result;
+  {
+    base::AutoLock lock(lock_);
+    auto it = entries_.Get(KeyForUrl(url));
+    if (it != entries_.end()) {
+      if (it->second.generation == generation)
+        result = it->second.resources;
+      else
+        entries_.Erase(it);
+    }
+  }
+  UMA_HISTOGRAM_BOOLEAN("Brave.Shields.CosmeticResourcesCacheHit",
+                        result.has_value());
+  return result;
+}
+
+void AdBlockCosmeticResourcesCache::Put(const std::string& url,
+                                        uint64_t generation,
+                                        const CosmeticResources& resources) {
+  const std::string key = KeyForUrl(url);
+  base::AutoLock lock(lock_);
+  auto it = entries_.Peek(key);
+  // Don't let a lookup that raced with an engine update replace a newer
+  // entry.
+  if (it != entries_.end() && it->second.generation > generation)
+    return;
+  entries_.Put(key, Entry{generation, resources});
+}
+
+// static
+std::string AdBlockCosmeticResourcesCache::KeyForUrl(const std::string& url) {
+  GURL gurl(url);
+  if (!gurl.is_valid() || !gurl.has_ref())
+    return url;
+  GURL::Replacements replacements;
+  replacements.ClearRef();
+  return gurl.ReplaceComponents(replacements).spec();
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,57 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
+#include "third_party/abseil-cpp/absl/types/optional.h"
+
+namespace brave_shields {
+
+// Recently computed url-specific cosmetic resources, so subframes and repeat
+// visits can be answered without a round trip to the adblock task runner.
+// Every entry is tagged with the engine generation it was computed for and
+// is ignored once any engine has changed since.
+//
+// Safe to use from any thread.
+class AdBlockCosmeticResourcesCache {
+ public:
+  explicit AdBlockCosmeticResourcesCache(size_t max_size);
+  ~AdBlockCosmeticResourcesCache();
+
+  // Returns the cached resources for `url` if they were computed for
+  // `generation`.
+  absl::optional<CosmeticResources> Get(const std::string& url,
+                                        uint64_t generation);
+  void Put(const std::string& url,
+           uint64_t generation,
+           const CosmeticResources& resources);
+
+ private:
+  struct Entry {
+    uint64_t generation;
+    CosmeticResources resources;
+  };
+
+  // Resources don't depend on the fragment, so it is dropped from the key.
+  static std::string KeyForUrl(const std::string& url);
+
+  base::Lock lock_;
+  base::MRUCache<std::string, Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockCosmeticResourcesCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_COSMETIC_RESOURCES_CACHE_H_
@@ -0,0 +1,81 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources_cache.h"
+
+#include "base/test/metrics/histogram_tester.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kCacheHitHistogram[] = "Brave.Shields.CosmeticResourcesCacheHit";
+
+CosmeticResources ResourcesWithHideSelector(const std::string& selector) {
+  CosmeticResources resources;
+  resources.hide_selectors.insert(selector);
+  return resources;
+}
+
+}  // namespace
+
+TEST(AdBlockCosmeticResourcesCacheTest, HitForSameGeneration) {
+  base::HistogramTester histogram_tester;
+  AdBlockCosmeticResourcesCache cache(4);
+
+  EXPECT_FALSE(cache.Get("https://a.com/", 1));
+  cache.Put("https://a.com/", 1, ResourcesWithHideSelector(".ad"));
+
+  absl::optional<CosmeticResources> cached = cache.Get("https://a.com/", 1);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(1u, cached->hide_selectors.count(".ad"));
+
+  histogram_tester.ExpectBucketCount(kCacheHitHistogram, false, 1);
+  histogram_tester.ExpectBucketCount(kCacheHitHistogram, true, 1);
+}
+
+TEST(AdBlockCosmeticResourcesCacheTest, MissAfterEngineChange) {
+  AdBlockCosmeticResourcesCache cache(4);
+  cache.Put("https://a.com/", 1, ResourcesWithHideSelector(".ad"));
+
+  EXPECT_FALSE(cache.Get("https://a.com/", 2));
+  // The stale entry is dropped rather than revived.
+  EXPECT_FALSE(cache.Get("https://a.com/", 1));
+}
+
+TEST(AdBlockCosmeticResourcesCacheTest, IgnoresFragment) {
+  AdBlockCosmeticResourcesCache cache(4);
+  cache.Put("https://a.com/page#top", 1, ResourcesWithHideSelector(".ad"));
+
+  EXPECT_TRUE(cache.Get("https://a.com/page", 1));
+  EXPECT_TRUE(cache.Get("https://a.com/page#bottom", 1));
+  EXPECT_FALSE(cache.Get("https://a.com/other", 1));
+}
+
+TEST(AdBlockCosmeticResourcesCacheTest, StalePutDoesNotReplaceNewer) {
+  AdBlockCosmeticResourcesCache cache(4);
+  cache.Put("https://a.com/", 2, ResourcesWithHideSelector(".new"));
+  cache.Put("https://a.com/", 1, ResourcesWithHideSelector(".old"));
+
+  absl::optional<CosmeticResources> cached = cache.Get("https://a.com/", 2);
+  ASSERT_TRUE(cached);
+  EXPECT_EQ(1u, cached->hide_selectors.count(".new"));
+}
+
+TEST(AdBlockCosmeticResourcesCacheTest, EvictsLeastRecentlyUsed) {
+  AdBlockCosmeticResourcesCache cache(2);
+  cache.Put("https://a.com/", 1, CosmeticResources());
+  cache.Put("https://b.com/", 1, CosmeticResources());
+  EXPECT_TRUE(cache.Get("https://a.com/", 1));
+
+  cache.Put("https://c.com/", 1, CosmeticResources());
+
+  EXPECT_TRUE(cache.Get("https://a.com/", 1));
+  EXPECT_FALSE(cache.Get("https://b.com/", 1));
+  EXPECT_TRUE(cache.Get("https://c.com/", 1));
+}
+
+}  // namespace brave_shields
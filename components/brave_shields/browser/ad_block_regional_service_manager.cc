@@ -115,11 +115,8 @@ bool AdBlockRegionalServiceManager::Start() {
   return true;
 }
 
-void AdBlockRegionalServiceManager::ShouldStartRequest(
-    const GURL& url,
-    blink::mojom::ResourceType resource_type,
-    const std::string& tab_host,
-    bool aggressive_blocking,
+void AdBlockRegionalServiceManager::MatchRequest(
+    const AdBlockRequestQuery& query,
     bool* did_match_rule,
     bool* did_match_exception,
     bool* did_match_important,
@@ -130,9 +127,9 @@ void AdBlockRegionalServiceManager::ShouldStartRequest(
   base::AutoLock lock(regional_services_lock_);
 
   for (const auto& regional_service : regional_services_) {
-    regional_service.second->ShouldStartRequest(
-        url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-        did_match_exception, did_match_important, mock_data_url);
+    regional_service.second->MatchRequest(query, did_match_rule,
+                                          did_match_exception,
+                                          did_match_important, mock_data_url);
     if (did_match_important && *did_match_important) {
       return;
     }
@@ -195,6 +192,7 @@ void AdBlockRegionalServiceManager::EnableFilterList(
       it->second->Unregister();
       regional_services_.erase(it);
     }
+    AdBlockBaseService::IncrementEngineGeneration();
   }
 
   // Update preferences to reflect enabled/disabled state of specified
@@ -205,26 +203,17 @@ void AdBlockRegionalServiceManager::EnableFilterList(
                      base::Unretained(this), uuid, enabled));
 }
 
-absl::optional<base::Value> AdBlockRegionalServiceManager::UrlCosmeticResources(
-    const std::string& url) {
+absl::optional<CosmeticResources>
+AdBlockRegionalServiceManager::UrlCosmeticResources(const std::string& url) {
   base::AutoLock lock(regional_services_lock_);
   auto it = regional_services_.begin();
   if (it == regional_services_.end()) {
-    return absl::optional<base::Value>();
+    return absl::nullopt;
   }
-  absl::optional<base::Value> first_value =
-      it->second->UrlCosmeticResources(url);
+  CosmeticResources first_value = it->second->UrlCosmeticResources(url);
 
-  for ( ; it != regional_services_.end(); it++) {
-    absl::optional<base::Value> next_value =
-        it->second->UrlCosmeticResources(url);
-    if (first_value) {
-      if (next_value) {
-        MergeResourcesInto(std::move(*next_value), &*first_value, false);
-      }
-    } else {
-      first_value = std::move(next_value);
-    }
+  for (it++; it != regional_services_.end(); it++) {
+    first_value.MergeFrom(it->second->UrlCosmeticResources(url), false);
   }
 
   return first_value;
@@ -17,6 +17,7 @@
 #include "base/values.h"
 #include "brave/components/adblock_rust_ffi/src/wrapper.h"
 #include "brave/components/brave_component_updater/browser/brave_component.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
 #include "third_party/blink/public/mojom/loader/resource_load_info.mojom-shared.h"
 #include "url/gurl.h"
@@ -32,6 +33,7 @@ using brave_component_updater::BraveComponent;
 namespace brave_shields {
 
 class AdBlockRegionalService;
+struct AdBlockRequestQuery;
 
 // The AdBlock regional service manager, in charge of initializing and
 // managing regional AdBlock clients.
@@ -47,14 +49,11 @@ class AdBlockRegionalServiceManager {
 
   bool IsInitialized() const;
   bool Start();
-  void ShouldStartRequest(const GURL& url,
-                          blink::mojom::ResourceType resource_type,
-                          const std::string& tab_host,
-                          bool aggressive_blocking,
-                          bool* did_match_rule,
-                          bool* did_match_exception,
-                          bool* did_match_important,
-                          std::string* mock_data_url);
+  void MatchRequest(const AdBlockRequestQuery& query,
+                    bool* did_match_rule,
+                    bool* did_match_exception,
+                    bool* did_match_important,
+                    std::string* mock_data_url);
   absl::optional<std::string> GetCspDirectives(
       const GURL& url,
       blink::mojom::ResourceType resource_type,
@@ -63,7 +62,8 @@ class AdBlockRegionalServiceManager {
   void AddResources(const std::string& resources);
   void EnableFilterList(const std::string& uuid, bool enabled);
 
-  absl::optional<base::Value> UrlCosmeticResources(const std::string& url);
+  absl::optional<CosmeticResources> UrlCosmeticResources(
+      const std::string& url);
   absl::optional<base::Value> HiddenClassIdSelectors(
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
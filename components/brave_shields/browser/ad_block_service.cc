@@ -40,6 +40,10 @@ namespace brave_shields {
 
 namespace {
 
+// Each entry can hold several thousand selectors, so only the most recently
+// visited pages are kept.
+constexpr size_t kCosmeticResourcesCacheSize = 32;
+
 // Extracts the start and end characters of a domain from a hostname.
 // Required for correct functionality of adblock-rust.
 void AdBlockServiceDomainResolver(const char* host,
@@ -76,37 +80,38 @@ void AdBlockService::ShouldStartRequest(
   if (!IsInitialized())
     return;
 
+  // Every engine below sees the same request, so the spec, hosts, third-party
+  // state and resource type are only worked out once and then shared.
+  const AdBlockRequestQuery query(url, resource_type, tab_host);
+
   if (aggressive_blocking ||
       base::FeatureList::IsEnabled(
           brave_shields::features::kBraveAdblockDefault1pBlocking) ||
-      !SameDomainOrHost(
-          url, url::Origin::CreateFromNormalizedTuple("https", tab_host, 80),
-          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)) {
-    AdBlockBaseService::ShouldStartRequest(
-        url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-        did_match_exception, did_match_important, mock_data_url);
+      query.is_third_party) {
+    MatchRequest(query, did_match_rule, did_match_exception,
+                 did_match_important, mock_data_url);
     if (did_match_important && *did_match_important) {
       return;
     }
   }
 
-  regional_service_manager()->ShouldStartRequest(
-      url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-      did_match_exception, did_match_important, mock_data_url);
+  regional_service_manager()->MatchRequest(query, did_match_rule,
+                                           did_match_exception,
+                                           did_match_important, mock_data_url);
   if (did_match_important && *did_match_important) {
     return;
   }
 
-  subscription_service_manager()->ShouldStartRequest(
-      url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-      did_match_exception, did_match_important, mock_data_url);
+  subscription_service_manager()->MatchRequest(
+      query, did_match_rule, did_match_exception, did_match_important,
+      mock_data_url);
   if (did_match_important && *did_match_important) {
     return;
   }
 
-  custom_filters_service()->ShouldStartRequest(
-      url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-      did_match_exception, did_match_important, mock_data_url);
+  custom_filters_service()->MatchRequest(query, did_match_rule,
+                                         did_match_exception,
+                                         did_match_important, mock_data_url);
 }
 
 absl::optional<std::string> AdBlockService::GetCspDirectives(
@@ -127,42 +132,41 @@ absl::optional<std::string> AdBlockService::GetCspDirectives(
   return csp_directives;
 }
 
-absl::optional<base::Value> AdBlockService::UrlCosmeticResources(
+CosmeticResources AdBlockService::UrlCosmeticResources(
     const std::string& url) {
-  absl::optional<base::Value> resources =
-      AdBlockBaseService::UrlCosmeticResources(url);
-
-  if (!resources || !resources->is_dict()) {
-    return resources;
-  }
+  // Read before querying any engine, so that an update racing with this
+  // lookup leaves the result tagged as stale.
+  const uint64_t generation = GetEngineGeneration();
+  CosmeticResources resources = AdBlockBaseService::UrlCosmeticResources(url);
 
-  absl::optional<base::Value> regional_resources =
+  absl::optional<CosmeticResources> regional_resources =
       regional_service_manager()->UrlCosmeticResources(url);
 
-  if (regional_resources && regional_resources->is_dict()) {
-    MergeResourcesInto(std::move(*regional_resources), &*resources,
-                       /*force_hide=*/false);
+  if (regional_resources) {
+    resources.MergeFrom(std::move(*regional_resources),
+                        /*force_hide=*/false);
   }
 
-  absl::optional<base::Value> custom_resources =
-      custom_filters_service()->UrlCosmeticResources(url);
+  resources.MergeFrom(custom_filters_service()->UrlCosmeticResources(url),
+                      /*force_hide=*/true);
 
-  if (custom_resources && custom_resources->is_dict()) {
-    MergeResourcesInto(std::move(*custom_resources), &*resources,
-                       /*force_hide=*/true);
-  }
-
-  absl::optional<base::Value> subscription_resources =
+  absl::optional<CosmeticResources> subscription_resources =
       subscription_service_manager()->UrlCosmeticResources(url);
 
-  if (subscription_resources && subscription_resources->is_dict()) {
-    MergeResourcesInto(std::move(*subscription_resources), &*resources,
-                       /*force_hide=*/true);
+  if (subscription_resources) {
+    resources.MergeFrom(std::move(*subscription_resources),
+                        /*force_hide=*/true);
   }
 
+  cosmetic_resources_cache_.Put(url, generation, resources);
   return resources;
 }
 
+absl::optional<CosmeticResources>
+AdBlockService::GetCachedUrlCosmeticResources(const std::string& url) {
+  return cosmetic_resources_cache_.Get(url, GetEngineGeneration());
+}
+
 absl::optional<base::Value> AdBlockService::HiddenClassIdSelectors(
     const std::vector<std::string>& classes,
     const std::vector<std::string>& ids,
@@ -255,7 +259,8 @@ AdBlockService::AdBlockService(
         subscription_service_manager)
     : AdBlockBaseService(delegate),
       component_delegate_(delegate),
-      subscription_service_manager_(std::move(subscription_service_manager)) {}
+      subscription_service_manager_(std::move(subscription_service_manager)),
+      cosmetic_resources_cache_(kCosmeticResourcesCacheSize) {}
 
 AdBlockService::~AdBlockService() {}
 
@@ -14,6 +14,7 @@
 
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
+#include "brave/components/brave_shields/browser/ad_block_cosmetic_resources_cache.h"
 #include "components/keyed_service/core/keyed_service.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "content/public/browser/browser_thread.h"
@@ -64,8 +65,11 @@ class AdBlockService : public AdBlockBaseService {
       const GURL& url,
       blink::mojom::ResourceType resource_type,
       const std::string& tab_host);
-  absl::optional<base::Value> UrlCosmeticResources(
-      const std::string& url) override;
+  CosmeticResources UrlCosmeticResources(const std::string& url) override;
+  // Returns the resources last computed by `UrlCosmeticResources` for `url`,
+  // if no engine has changed since. May be called from any thread.
+  absl::optional<CosmeticResources> GetCachedUrlCosmeticResources(
+      const std::string& url);
   absl::optional<base::Value> HiddenClassIdSelectors(
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
@@ -102,6 +106,8 @@ class AdBlockService : public AdBlockBaseService {
   std::unique_ptr<brave_shields::AdBlockSubscriptionServiceManager>
       subscription_service_manager_;
 
+  AdBlockCosmeticResourcesCache cosmetic_resources_cache_;
+
   base::WeakPtrFactory<AdBlockService> weak_factory_{this};
   DISALLOW_COPY_AND_ASSIGN(AdBlockService);
 };
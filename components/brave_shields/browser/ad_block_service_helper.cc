@@ -139,80 +139,100 @@ void MergeCspDirectiveInto(absl::optional<std::string> from,
   *into = absl::optional<std::string>(from_str + ", " + into_str);
 }
 
-// Merges the contents of the first UrlCosmeticResources Value into the second
-// one provided.
-//
-// If `force_hide` is true, the contents of `from`'s `hide_selectors` field
-// will be moved into a possibly new field of `into` called
-// `force_hide_selectors`.
-void MergeResourcesInto(base::Value from, base::Value* into, bool force_hide) {
-  base::Value* resources_hide_selectors = nullptr;
-  if (force_hide) {
-    resources_hide_selectors = into->FindKey("force_hide_selectors");
-    if (!resources_hide_selectors || !resources_hide_selectors->is_list()) {
-        into->SetKey("force_hide_selectors", base::ListValue());
-        resources_hide_selectors = into->FindKey("force_hide_selectors");
-    }
+CosmeticResources::CosmeticResources() = default;
+
+CosmeticResources::CosmeticResources(
+    adblock::CosmeticResources engine_resources)
+    : hide_selectors(engine_resources.hide_selectors.begin(),
+                     engine_resources.hide_selectors.end()),
+      style_selectors(std::move(engine_resources.style_selectors)),
+      exceptions(engine_resources.exceptions.begin(),
+                 engine_resources.exceptions.end()),
+      injected_script(std::move(engine_resources.injected_script)),
+      generichide(engine_resources.generichide) {}
+
+CosmeticResources::CosmeticResources(const CosmeticResources& other) =
+    default;
+
+CosmeticResources::CosmeticResources(CosmeticResources&& other) = default;
+
+CosmeticResources& CosmeticResources::operator=(
+    const CosmeticResources& other) = default;
+
+CosmeticResources& CosmeticResources::operator=(CosmeticResources&& other) =
+    default;
+
+CosmeticResources::~CosmeticResources() = default;
+
+void CosmeticResources::MergeFrom(CosmeticResources from, bool force_hide) {
+  std::set<std::string>* into_hide_selectors =
+      force_hide ? &force_hide_selectors : &hide_selectors;
+  if (into_hide_selectors->empty()) {
+    into_hide_selectors->swap(from.hide_selectors);
   } else {
-    resources_hide_selectors = into->FindKey("hide_selectors");
-  }
-  base::Value* from_resources_hide_selectors =
-      from.FindKey("hide_selectors");
-  if (resources_hide_selectors && from_resources_hide_selectors) {
-    for (auto i = from_resources_hide_selectors->GetList().begin();
-            i < from_resources_hide_selectors->GetList().end();
-            i++) {
-      resources_hide_selectors->Append(std::move(*i));
-    }
+    into_hide_selectors->insert(from.hide_selectors.begin(),
+                                from.hide_selectors.end());
   }
+  force_hide_selectors.insert(from.force_hide_selectors.begin(),
+                              from.force_hide_selectors.end());
 
-  base::Value* resources_style_selectors = into->FindKey("style_selectors");
-  base::Value* from_resources_style_selectors =
-      from.FindKey("style_selectors");
-  if (resources_style_selectors && from_resources_style_selectors) {
-    for (auto i : from_resources_style_selectors->DictItems()) {
-      base::Value* resources_entry =
-          resources_style_selectors->FindKey(i.first);
-      if (resources_entry) {
-        for (auto j = i.second.GetList().begin();
-                j < i.second.GetList().end();
-                j++) {
-          resources_entry->Append(std::move(*j));
-        }
-      } else {
-        resources_style_selectors->SetKey(i.first, std::move(i.second));
-      }
+  for (auto& from_entry : from.style_selectors) {
+    std::vector<std::string>& styles = style_selectors[from_entry.first];
+    if (styles.empty()) {
+      styles = std::move(from_entry.second);
+      continue;
+    }
+    for (auto& style : from_entry.second) {
+      if (std::find(styles.begin(), styles.end(), style) == styles.end())
+        styles.push_back(std::move(style));
     }
   }
 
-  base::Value* resources_exceptions = into->FindKey("exceptions");
-  base::Value* from_resources_exceptions = from.FindKey("exceptions");
-  if (resources_exceptions && from_resources_exceptions) {
-    for (auto i = from_resources_exceptions->GetList().begin();
-            i < from_resources_exceptions->GetList().end();
-            i++) {
-      resources_exceptions->Append(std::move(*i));
-    }
+  if (exceptions.empty()) {
+    exceptions.swap(from.exceptions);
+  } else {
+    exceptions.insert(from.exceptions.begin(), from.exceptions.end());
   }
 
-  base::Value* resources_injected_script = into->FindKey("injected_script");
-  base::Value* from_resources_injected_script =
-      from.FindKey("injected_script");
-  if (resources_injected_script && from_resources_injected_script) {
-    *resources_injected_script = base::Value(
-            resources_injected_script->GetString()
-            + '\n'
-            + from_resources_injected_script->GetString());
+  if (injected_script.empty()) {
+    injected_script = std::move(from.injected_script);
+  } else if (!from.injected_script.empty()) {
+    injected_script += '\n';
+    injected_script += from.injected_script;
   }
 
-  base::Value* resources_generichide = into->FindKey("generichide");
-  base::Value* from_resources_generichide =
-      from.FindKey("generichide");
-  if (from_resources_generichide) {
-    if (from_resources_generichide->GetBool()) {
-      *resources_generichide = base::Value(true);
-    }
+  generichide = generichide || from.generichide;
+}
+
+base::Value CosmeticResources::ToValue() const {
+  base::Value hide_selectors_list(base::Value::Type::LIST);
+  for (const auto& selector : hide_selectors)
+    hide_selectors_list.Append(base::Value(selector));
+
+  base::Value force_hide_selectors_list(base::Value::Type::LIST);
+  for (const auto& selector : force_hide_selectors)
+    force_hide_selectors_list.Append(base::Value(selector));
+
+  base::Value style_selectors_dict(base::Value::Type::DICTIONARY);
+  for (const auto& entry : style_selectors) {
+    base::Value styles_list(base::Value::Type::LIST);
+    for (const auto& style : entry.second)
+      styles_list.Append(base::Value(style));
+    style_selectors_dict.SetKey(entry.first, std::move(styles_list));
   }
+
+  base::Value exceptions_list(base::Value::Type::LIST);
+  for (const auto& exception : exceptions)
+    exceptions_list.Append(base::Value(exception));
+
+  base::Value result(base::Value::Type::DICTIONARY);
+  result.SetKey("hide_selectors", std::move(hide_selectors_list));
+  result.SetKey("force_hide_selectors", std::move(force_hide_selectors_list));
+  result.SetKey("style_selectors", std::move(style_selectors_dict));
+  result.SetKey("exceptions", std::move(exceptions_list));
+  result.SetStringKey("injected_script", injected_script);
+  result.SetBoolKey("generichide", generichide);
+  return result;
 }
 
 }  // namespace brave_shields
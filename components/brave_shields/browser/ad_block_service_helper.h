@@ -7,6 +7,8 @@
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SERVICE_HELPER_H_
 
 #include <stdint.h>
+#include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -16,6 +18,36 @@
 
 namespace brave_shields {
 
+// Url-specific cosmetic filtering resources, merged across every engine that
+// applies to a page. Selectors are kept in sets so that rules shared by
+// several filter lists are only sent to the renderer once.
+struct CosmeticResources {
+  CosmeticResources();
+  explicit CosmeticResources(adblock::CosmeticResources engine_resources);
+  CosmeticResources(const CosmeticResources& other);
+  CosmeticResources(CosmeticResources&& other);
+  CosmeticResources& operator=(const CosmeticResources& other);
+  CosmeticResources& operator=(CosmeticResources&& other);
+  ~CosmeticResources();
+
+  // Merges the contents of `from` into this one.
+  //
+  // If `force_hide` is true, `from`'s `hide_selectors` are merged into
+  // `force_hide_selectors` instead.
+  void MergeFrom(CosmeticResources from, bool force_hide);
+
+  // Returns the dictionary form used by the brave_shields extension API.
+  base::Value ToValue() const;
+
+  std::set<std::string> hide_selectors;
+  std::set<std::string> force_hide_selectors;
+  // Styles keep the order they were added in, since later declarations win.
+  std::map<std::string, std::vector<std::string>> style_selectors;
+  std::set<std::string> exceptions;
+  std::string injected_script;
+  bool generichide = false;
+};
+
 std::vector<adblock::FilterList>::const_iterator FindAdBlockFilterListByUUID(
     const std::vector<adblock::FilterList>& region_lists,
     const std::string& uuid);
@@ -29,8 +61,6 @@ std::vector<adblock::FilterList> RegionalCatalogFromJSON(
 void MergeCspDirectiveInto(absl::optional<std::string> from,
                            absl::optional<std::string>* into);
 
-void MergeResourcesInto(base::Value from, base::Value* into, bool force_hide);
-
 }  // namespace brave_shields
 
 #endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_AD_BLOCK_SERVICE_HELPER_H_
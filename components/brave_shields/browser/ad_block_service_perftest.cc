@@ -0,0 +1,154 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/bind.h"
+#include "brave/components/adblock_rust_ffi/src/wrapper.h"
+#include "brave/components/brave_shields/browser/ad_block_base_service.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
+#include "brave/test/base/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "AdBlockMatchRequest.";
+constexpr char kMetricPerRequest[] = "per_request";
+constexpr char kCosmeticMetricPrefix[] = "AdBlockUrlCosmeticResources.";
+constexpr char kMetricPerNavigation[] = "per_navigation";
+
+constexpr int kRulesPerList = 5000;
+constexpr int kRequestCount = 100;
+constexpr int kCosmeticRulesPerList = 2000;
+constexpr int kNavigationCount = 20;
+
+std::string BuildFilterList(int list_index) {
+  std::string rules;
+  for (int i = 0; i < kRulesPerList; ++i) {
+    rules += base::StringPrintf("||ads%d-%d.example.com^\n", list_index, i);
+    rules += base::StringPrintf("/banner/%d/%d/*$image,third-party\n",
+                                list_index, i);
+  }
+  // Every list blocks this tracker as $important, so requests for it also
+  // exercise the early exit after the first engine.
+  rules += "||tracker.example.net^$important\n";
+  return rules;
+}
+
+std::vector<GURL> BuildRequests() {
+  std::vector<GURL> requests;
+  for (int i = 0; i < kRequestCount; ++i) {
+    requests.push_back(
+        GURL(base::StringPrintf("https://cdn%d.example.org/assets/%d.js", i,
+                                i)));
+  }
+  requests.push_back(GURL("https://tracker.example.net/pixel.gif"));
+  return requests;
+}
+
+std::string BuildCosmeticFilterList(int list_index) {
+  std::string rules;
+  for (int i = 0; i < kCosmeticRulesPerList; ++i) {
+    rules += base::StringPrintf("site%d.example.com##.ad-%d-%d\n", i % 50,
+                                list_index, i);
+    rules += base::StringPrintf(
+        "site%d.example.com##div:style(margin: %dpx)\n", i % 50, i);
+  }
+  // Lists commonly share the same popular site-specific rules; these should
+  // only reach the renderer once.
+  for (int i = 0; i < 50; ++i)
+    rules += base::StringPrintf("site%d.example.com##.shared-banner\n", i);
+  return rules;
+}
+
+}  // namespace
+
+class AdBlockServicePerfTest : public testing::Test {
+ protected:
+  void RunForListCount(size_t list_count) {
+    std::vector<std::unique_ptr<adblock::Engine>> engines;
+    for (int i = 0; i < static_cast<int>(list_count); ++i) {
+      engines.push_back(
+          std::make_unique<adblock::Engine>(BuildFilterList(i)));
+    }
+    const std::vector<GURL> requests = BuildRequests();
+
+    brave::RunPerfTest(
+        kMetricPrefix, kMetricPerRequest,
+        base::NumberToString(list_count) + "_lists", requests.size(),
+        base::BindLambdaForTesting([&]() {
+          for (const auto& url : requests) {
+            // Mirrors `AdBlockService::ShouldStartRequest`: the query is
+            // built once and every engine is consulted until an $important
+            // match.
+            const AdBlockRequestQuery query(
+                url, blink::mojom::ResourceType::kScript, "www.example.com");
+            bool did_match_rule = false;
+            bool did_match_exception = false;
+            bool did_match_important = false;
+            std::string mock_data_url;
+            for (const auto& engine : engines) {
+              engine->matches(query.url, query.host, query.tab_host,
+                              query.is_third_party, query.resource_type,
+                              &did_match_rule, &did_match_exception,
+                              &did_match_important, &mock_data_url);
+              if (did_match_important)
+                break;
+            }
+          }
+        }));
+  }
+};
+
+class AdBlockCosmeticResourcesPerfTest : public testing::Test {
+ protected:
+  void RunForListCount(size_t list_count) {
+    std::vector<std::unique_ptr<adblock::Engine>> engines;
+    for (int i = 0; i < static_cast<int>(list_count); ++i) {
+      engines.push_back(
+          std::make_unique<adblock::Engine>(BuildCosmeticFilterList(i)));
+    }
+
+    brave::RunPerfTest(
+        kCosmeticMetricPrefix, kMetricPerNavigation,
+        base::NumberToString(list_count) + "_lists", kNavigationCount,
+        base::BindLambdaForTesting([&]() {
+          for (int i = 0; i < kNavigationCount; ++i) {
+            // Mirrors `AdBlockService::UrlCosmeticResources`: every engine's
+            // result is merged into the first one.
+            const std::string url =
+                base::StringPrintf("https://site%d.example.com/", i);
+            CosmeticResources resources(
+                engines[0]->urlCosmeticResourcesStructured(url));
+            for (size_t j = 1; j < engines.size(); ++j) {
+              CosmeticResources next(
+                  engines[j]->urlCosmeticResourcesStructured(url));
+              resources.MergeFrom(std::move(next), /*force_hide=*/false);
+            }
+            EXPECT_FALSE(resources.hide_selectors.empty());
+          }
+        }));
+  }
+};
+
+TEST_F(AdBlockCosmeticResourcesPerfTest, UrlCosmeticResourcesByListCount) {
+  for (size_t list_count : {1, 2, 4, 6, 8, 12})
+    RunForListCount(list_count);
+}
+
+TEST_F(AdBlockServicePerfTest, MatchRequestByEnabledListCount) {
+  for (size_t list_count : {1, 2, 4, 6, 8, 12})
+    RunForListCount(list_count);
+}
+
+}  // namespace brave_shields
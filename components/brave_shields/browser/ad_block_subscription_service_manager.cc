@@ -202,6 +202,7 @@ void AdBlockSubscriptionServiceManager::EnableSubscription(const GURL& sub_url,
   info->enabled = enabled;
 
   UpdateSubscriptionPrefs(sub_url, *info);
+  AdBlockBaseService::IncrementEngineGeneration();
 }
 
 void AdBlockSubscriptionServiceManager::DeleteSubscription(
@@ -214,6 +215,7 @@ void AdBlockSubscriptionServiceManager::DeleteSubscription(
     subscription_services_.erase(it);
   }
   ClearSubscriptionPrefs(sub_url);
+  AdBlockBaseService::IncrementEngineGeneration();
 
   base::ThreadPool::PostTask(
       FROM_HERE,
@@ -276,6 +278,14 @@ absl::optional<SubscriptionInfo> AdBlockSubscriptionServiceManager::GetInfo(
       BuildInfoFromDict(sub_url, list_subscription_dict));
 }
 
+bool AdBlockSubscriptionServiceManager::IsEnabled(const GURL& sub_url) {
+  const auto* list_subscription_dict = subscriptions_->FindKey(sub_url.spec());
+  if (!list_subscription_dict)
+    return false;
+
+  return list_subscription_dict->FindBoolKey("enabled").value_or(false);
+}
+
 void AdBlockSubscriptionServiceManager::LoadSubscriptionServices() {
   DCHECK_CALLED_ON_VALID_THREAD(thread_checker_);
 
@@ -362,22 +372,18 @@ bool AdBlockSubscriptionServiceManager::Start() {
   return true;
 }
 
-void AdBlockSubscriptionServiceManager::ShouldStartRequest(
-    const GURL& url,
-    blink::mojom::ResourceType resource_type,
-    const std::string& tab_host,
-    bool aggressive_blocking,
+void AdBlockSubscriptionServiceManager::MatchRequest(
+    const AdBlockRequestQuery& query,
     bool* did_match_rule,
     bool* did_match_exception,
     bool* did_match_important,
     std::string* mock_data_url) {
   base::AutoLock lock(subscription_services_lock_);
   for (const auto& subscription_service : subscription_services_) {
-    auto info = GetInfo(subscription_service.first);
-    if (info && info->enabled) {
-      subscription_service.second->ShouldStartRequest(
-          url, resource_type, tab_host, aggressive_blocking, did_match_rule,
-          did_match_exception, did_match_important, mock_data_url);
+    if (IsEnabled(subscription_service.first)) {
+      subscription_service.second->MatchRequest(
+          query, did_match_rule, did_match_exception, did_match_important,
+          mock_data_url);
       if (did_match_important && *did_match_important) {
         return;
       }
@@ -401,22 +407,18 @@ void AdBlockSubscriptionServiceManager::AddResources(
   }
 }
 
-absl::optional<base::Value>
+absl::optional<CosmeticResources>
 AdBlockSubscriptionServiceManager::UrlCosmeticResources(
     const std::string& url) {
-  absl::optional<base::Value> first_value = absl::nullopt;
+  absl::optional<CosmeticResources> first_value = absl::nullopt;
 
   base::AutoLock lock(subscription_services_lock_);
   for (auto it = subscription_services_.begin();
        it != subscription_services_.end(); it++) {
-    auto info = GetInfo(it->first);
-    if (info && info->enabled) {
-      absl::optional<base::Value> next_value =
-          it->second->UrlCosmeticResources(url);
+    if (IsEnabled(it->first)) {
+      CosmeticResources next_value = it->second->UrlCosmeticResources(url);
       if (first_value) {
-        if (next_value) {
-          MergeResourcesInto(std::move(*next_value), &*first_value, false);
-        }
+        first_value->MergeFrom(std::move(next_value), false);
       } else {
         first_value = std::move(next_value);
       }
@@ -436,8 +438,7 @@ AdBlockSubscriptionServiceManager::HiddenClassIdSelectors(
   base::AutoLock lock(subscription_services_lock_);
   for (auto it = subscription_services_.begin();
        it != subscription_services_.end(); it++) {
-    auto info = GetInfo(it->first);
-    if (info && info->enabled) {
+    if (IsEnabled(it->first)) {
       absl::optional<base::Value> next_value =
           it->second->HiddenClassIdSelectors(classes, ids, exceptions);
       if (first_value && first_value->is_list()) {
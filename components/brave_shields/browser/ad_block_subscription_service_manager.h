@@ -19,6 +19,7 @@
 #include "base/threading/thread_checker.h"
 #include "base/values.h"
 #include "brave/components/brave_component_updater/browser/brave_component.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_download_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_subscription_service.h"
 #include "components/component_updater/timer_update_scheduler.h"
@@ -29,6 +30,7 @@ class PrefService;
 
 namespace brave_shields {
 class AdBlockSubscriptionServiceManagerObserver;
+struct AdBlockRequestQuery;
 }
 
 class AdBlockServiceTest;
@@ -58,18 +60,16 @@ class AdBlockSubscriptionServiceManager {
   void CreateSubscription(const GURL& sub_url);
 
   bool Start();
-  void ShouldStartRequest(const GURL& url,
-                          blink::mojom::ResourceType resource_type,
-                          const std::string& tab_host,
-                          bool aggressive_blocking,
-                          bool* did_match_rule,
-                          bool* did_match_exception,
-                          bool* did_match_important,
-                          std::string* mock_data_url);
+  void MatchRequest(const AdBlockRequestQuery& query,
+                    bool* did_match_rule,
+                    bool* did_match_exception,
+                    bool* did_match_important,
+                    std::string* mock_data_url);
   void EnableTag(const std::string& tag, bool enabled);
   void AddResources(const std::string& resources);
 
-  absl::optional<base::Value> UrlCosmeticResources(const std::string& url);
+  absl::optional<CosmeticResources> UrlCosmeticResources(
+      const std::string& url);
   absl::optional<base::Value> HiddenClassIdSelectors(
       const std::vector<std::string>& classes,
       const std::vector<std::string>& ids,
@@ -105,6 +105,9 @@ class AdBlockSubscriptionServiceManager {
       AdBlockSubscriptionDownloadManager* download_manager);
 
   absl::optional<SubscriptionInfo> GetInfo(const GURL& sub_url);
+  // Cheaper than `GetInfo` for callers on the request path that only need to
+  // know whether the subscription is currently enabled.
+  bool IsEnabled(const GURL& sub_url);
   void NotifyObserversOfServiceEvent();
 
   void SetUpdateIntervalsForTesting(base::TimeDelta* initial_delay,
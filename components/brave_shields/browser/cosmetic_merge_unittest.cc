@@ -17,24 +17,45 @@ class CosmeticResourceMergeTest : public testing::Test {
   CosmeticResourceMergeTest() {}
   ~CosmeticResourceMergeTest() override {}
 
+  // Builds resources the same way an engine would return them.
+  CosmeticResources ResourcesFromString(const std::string& json) {
+    adblock::CosmeticResources engine_resources;
+    absl::optional<base::Value> value = base::JSONReader::Read(json);
+    EXPECT_TRUE(value && value->is_dict());
+    if (!value || !value->is_dict())
+      return CosmeticResources();
+
+    for (const auto& selector : value->FindListKey("hide_selectors")->GetList())
+      engine_resources.hide_selectors.push_back(selector.GetString());
+    for (const auto& entry :
+         value->FindDictKey("style_selectors")->DictItems()) {
+      for (const auto& style : entry.second.GetList())
+        engine_resources.style_selectors[entry.first].push_back(
+            style.GetString());
+    }
+    for (const auto& exception : value->FindListKey("exceptions")->GetList())
+      engine_resources.exceptions.push_back(exception.GetString());
+    engine_resources.injected_script =
+        *value->FindStringKey("injected_script");
+    engine_resources.generichide = *value->FindBoolKey("generichide");
+    return CosmeticResources(std::move(engine_resources));
+  }
+
   void CompareMergeFromStrings(
           const std::string& a,
           const std::string& b,
           bool force_hide,
           const std::string& expected) {
-    absl::optional<base::Value> a_val = base::JSONReader::Read(a);
-    ASSERT_TRUE(a_val);
-
-    absl::optional<base::Value> b_val = base::JSONReader::Read(b);
-    ASSERT_TRUE(b_val);
+    CosmeticResources a_resources = ResourcesFromString(a);
+    CosmeticResources b_resources = ResourcesFromString(b);
 
     const absl::optional<base::Value> expected_val =
         base::JSONReader::Read(expected);
     ASSERT_TRUE(expected_val);
 
-    MergeResourcesInto(std::move(b_val.value()), &*a_val, force_hide);
+    a_resources.MergeFrom(std::move(b_resources), force_hide);
 
-    ASSERT_EQ(*a_val, *expected_val);
+    ASSERT_EQ(a_resources.ToValue(), *expected_val);
   }
 
  protected:
@@ -66,13 +87,12 @@ TEST_F(CosmeticResourceMergeTest, MergeTwoEmptyResources) {
   const std::string a = EMPTY_RESOURCES;
   const std::string b = EMPTY_RESOURCES;
 
-  // Same as EMPTY_RESOURCES, but with an additional newline in the
-  // injected_script
   const std::string expected = "{"
       "\"hide_selectors\": [], "
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {}, "
       "\"exceptions\": [], "
-      "\"injected_script\": \"\n\", "
+      "\"injected_script\": \"\", "
       "\"generichide\": false"
   "}";
 
@@ -83,16 +103,16 @@ TEST_F(CosmeticResourceMergeTest, MergeEmptyIntoNonEmpty) {
   const std::string a = NONEMPTY_RESOURCES;
   const std::string b = EMPTY_RESOURCES;
 
-  // Same as a, but with an additional newline at the end of the
-  // injected_script
+  // Same as a; an empty injected_script adds nothing
   const std::string expected = "{"
       "\"hide_selectors\": [\"a\", \"b\"], "
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {"
           "\"c\": [\"color: #fff\"], "
           "\"d\": [\"color: #000\"]"
       "}, "
       "\"exceptions\": [\"e\", \"f\"], "
-      "\"injected_script\": \"console.log('g')\n\", "
+      "\"injected_script\": \"console.log('g')\", "
       "\"generichide\": false"
   "}";
 
@@ -103,16 +123,16 @@ TEST_F(CosmeticResourceMergeTest, MergeNonEmptyIntoEmpty) {
   const std::string a = EMPTY_RESOURCES;
   const std::string b = NONEMPTY_RESOURCES;
 
-  // Same as b, but with an additional newline at the beginning of the
-  // injected_script
+  // Same as b
   const std::string expected = "{"
       "\"hide_selectors\": [\"a\", \"b\"],"
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {"
           "\"c\": [\"color: #fff\"], "
           "\"d\": [\"color: #000\"]"
       "}, "
       "\"exceptions\": [\"e\", \"f\"], "
-      "\"injected_script\": \"\nconsole.log('g')\", "
+      "\"injected_script\": \"console.log('g')\", "
       "\"generichide\": false"
   "}";
 
@@ -134,6 +154,7 @@ TEST_F(CosmeticResourceMergeTest, MergeNonEmptyIntoNonEmpty) {
 
   const std::string expected = "{"
       "\"hide_selectors\": [\"a\", \"b\", \"h\", \"i\"], "
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {"
           "\"c\": [\"color: #fff\"], "
           "\"d\": [\"color: #000\"], "
@@ -152,13 +173,11 @@ TEST_F(CosmeticResourceMergeTest, MergeEmptyForceHide) {
   const std::string a = EMPTY_RESOURCES;
   const std::string b = EMPTY_RESOURCES;
 
-  // Same as EMPTY_RESOURCES, but with an additional newline in the
-  // injected_script and a new empty `force_hide_selectors` array
   const std::string expected = "{"
       "\"hide_selectors\": [], "
       "\"style_selectors\": {}, "
       "\"exceptions\": [], "
-      "\"injected_script\": \"\n\","
+      "\"injected_script\": \"\","
       "\"generichide\": false, "
       "\"force_hide_selectors\": []"
   "}";
@@ -201,16 +220,17 @@ TEST_F(CosmeticResourceMergeTest, MergeNonGenerichideIntoGenerichide) {
       "\"hide_selectors\": [], "
       "\"style_selectors\": {}, "
       "\"exceptions\": [], "
-      "\"injected_script\": \"\n\", "
+      "\"injected_script\": \"\", "
       "\"generichide\": true"
   "}";
   const std::string b = EMPTY_RESOURCES;
 
   const std::string expected = "{"
       "\"hide_selectors\": [], "
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {}, "
       "\"exceptions\": [], "
-      "\"injected_script\": \"\n\n\", "
+      "\"injected_script\": \"\", "
       "\"generichide\": true"
   "}";
 
@@ -232,6 +252,7 @@ TEST_F(CosmeticResourceMergeTest, MergeGenerichideIntoNonGenerichide) {
 
   const std::string expected = "{"
       "\"hide_selectors\": [\"a\", \"b\", \"h\", \"i\"], "
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {"
           "\"c\": [\"color: #fff\"], "
           "\"d\": [\"color: #000\"], "
@@ -257,9 +278,10 @@ TEST_F(CosmeticResourceMergeTest, MergeGenerichideIntoGenerichide) {
 
   const std::string expected = "{"
       "\"hide_selectors\": [], "
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {}, "
       "\"exceptions\": [], "
-      "\"injected_script\": \"\n\", "
+      "\"injected_script\": \"\", "
       "\"generichide\": true"
   "}";
 
@@ -292,6 +314,7 @@ TEST_F(CosmeticResourceMergeTest, MergeStyles) {
 
   const std::string expected = "{"
       "\"hide_selectors\": [], "
+      "\"force_hide_selectors\": [], "
       "\"style_selectors\": {"
           "\".a\": [\"color: #eee\", \"background: #fff\"], "
           "\".b\": [\"color: #111\", \"background: #000\"], "
@@ -299,12 +322,38 @@ TEST_F(CosmeticResourceMergeTest, MergeStyles) {
           "\".d\": [\"padding: 0\"] "
       "}, "
       "\"exceptions\": [], "
-      "\"injected_script\": \"\n\", "
+      "\"injected_script\": \"\", "
       "\"generichide\": false"
   "}";
 
   CompareMergeFromStrings(a, b, false, expected);
 }
 
+TEST_F(CosmeticResourceMergeTest, MergeDeduplicates) {
+  const std::string a = NONEMPTY_RESOURCES;
+  const std::string b = "{"
+      "\"hide_selectors\": [\"b\", \"h\"], "
+      "\"style_selectors\": {"
+          "\"c\": [\"color: #fff\", \"margin: 0\"]"
+      "}, "
+      "\"exceptions\": [\"f\", \"l\"], "
+      "\"injected_script\": \"\", "
+      "\"generichide\": false"
+  "}";
+
+  const std::string expected = "{"
+      "\"hide_selectors\": [\"a\", \"b\", \"h\"], "
+      "\"force_hide_selectors\": [], "
+      "\"style_selectors\": {"
+          "\"c\": [\"color: #fff\", \"margin: 0\"], "
+          "\"d\": [\"color: #000\"]"
+      "}, "
+      "\"exceptions\": [\"e\", \"f\", \"l\"], "
+      "\"injected_script\": \"console.log('g')\", "
+      "\"generichide\": false"
+  "}";
+
+  CompareMergeFromStrings(a, b, false, expected);
+}
 
 }  // namespace brave_shields
@@ -6,40 +6,214 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RECENTLY_USED_CACHE_H_
 #define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RECENTLY_USED_CACHE_H_
 
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
-#include "base/containers/mru_cache.h"
+#include "base/check_op.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 
+// Recently used URL cache shared by the IO path and the shields task runner.
+// Keys are spread over independently locked shards so concurrent lookups for
+// different URLs don't serialize, and each shard evicts with the CLOCK
+// algorithm, an approximation of LRU where a hit only sets a flag instead of
+// reordering a list.
 template <class T> class HTTPSERecentlyUsedCache {
  public:
-  explicit HTTPSERecentlyUsedCache(size_t size = 100) : data_(size) {}
+  explicit HTTPSERecentlyUsedCache(size_t size = 100) {
+    DCHECK_GT(size, 0u);
+    const size_t shard_count = std::min(
+        kMaxShards, std::max<size_t>(1, size / kMinEntriesPerShard));
+    // A shard without slots would have no victim to evict.
+    const size_t shard_size =
+        std::max<size_t>(1, (size + shard_count - 1) / shard_count);
+    for (size_t i = 0; i < shard_count; ++i)
+      shards_.push_back(std::make_unique<Shard>(shard_size));
+  }
 
   void add(const std::string& key, const T& value) {
-    base::AutoLock create(lock_);
-    data_.Put(key, value);
+    Shard* shard = GetShard(key);
+    ScopedShardLock lock(&shard->lock);
+    shard->Put(key, value);
   }
 
   bool get(const std::string& key, T* value) {
-    base::AutoLock create(lock_);
-    auto it = data_.Get(key);
-    if (it != data_.end()) {
-      *value = it->second;
-      return true;
+    Shard* shard = GetShard(key);
+    bool hit;
+    {
+      ScopedShardLock lock(&shard->lock);
+      hit = shard->Get(key, value);
     }
-    return false;
+    UMA_HISTOGRAM_BOOLEAN("Brave.HTTPSE.RecentlyUsedCacheHit", hit);
+    return hit;
   }
 
   void remove(const std::string& key) {
-    base::AutoLock lock(lock_);
-    auto it = data_.Peek(key);
-    if (it != data_.end())
-      data_.Erase(it);
+    Shard* shard = GetShard(key);
+    ScopedShardLock lock(&shard->lock);
+    shard->Erase(key);
   }
 
  private:
-  base::MRUCache<std::string, T> data_;
-  base::Lock lock_;
+  static constexpr size_t kMaxShards = 16;
+  static constexpr size_t kMinEntriesPerShard = 16;
+
+  struct Entry {
+    std::string key;
+    T value;
+    bool in_use = false;
+    bool referenced = false;
+  };
+
+  struct Shard {
+    explicit Shard(size_t size) : slots(size) {}
+
+    void Put(const std::string& key, const T& value) {
+      auto it = index.find(key);
+      if (it != index.end()) {
+        Entry& entry = slots[it->second];
+        entry.value = value;
+        entry.referenced = true;
+        return;
+      }
+
+      const size_t slot = NextVictim();
+      Entry& entry = slots[slot];
+      if (entry.in_use)
+        index.erase(entry.key);
+      entry.key = key;
+      entry.value = value;
+      entry.in_use = true;
+      entry.referenced = false;
+      index[key] = slot;
+    }
+
+    bool Get(const std::string& key, T* value) {
+      auto it = index.find(key);
+      if (it == index.end())
+        return false;
+      Entry& entry = slots[it->second];
+      entry.referenced = true;
+      *value = entry.value;
+      return true;
+    }
+
+    void Erase(const std::string& key) {
+      auto it = index.find(key);
+      if (it == index.end())
+        return;
+      Entry& entry = slots[it->second];
+      entry.in_use = false;
+      entry.referenced = false;
+      entry.key.clear();
+      index.erase(it);
+    }
+
+    // Sweeps the clock hand past recently referenced entries, clearing their
+    // flag, and returns the first free or unreferenced slot.
+    size_t NextVictim() {
+      while (true) {
+        Entry& entry = slots[hand];
+        const size_t slot = hand;
+        hand = (hand + 1) % slots.size();
+        if (!entry.in_use || !entry.referenced)
+          return slot;
+        entry.referenced = false;
+      }
+    }
+
+    base::Lock lock;
+    std::vector<Entry> slots;
+    std::unordered_map<std::string, size_t> index;
+    size_t hand = 0;
+  };
+
+  // Only records how long the lock took when it was actually contended, so
+  // the uncontended path stays a single try-lock.
+  class ScopedShardLock {
+   public:
+    explicit ScopedShardLock(base::Lock* lock) : lock_(lock) {
+      if (lock_->Try())
+        return;
+      const base::TimeTicks start = base::TimeTicks::Now();
+      lock_->Acquire();
+      UMA_HISTOGRAM_CUSTOM_MICROSECONDS_TIMES(
+          "Brave.HTTPSE.RecentlyUsedCacheLockWait",
+          base::TimeTicks::Now() - start,
+          base::TimeDelta::FromMicroseconds(1),
+          base::TimeDelta::FromMilliseconds(100), 50);
+    }
+    ~ScopedShardLock() { lock_->Release(); }
+
+   private:
+    base::Lock* lock_;
+  };
+
+  Shard* GetShard(const std::string& key) {
+    return shards_[std::hash<std::string>()(key) % shards_.size()].get();
+  }
+
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+// Tracks how many times HTTPS Everywhere has redirected a request. Requests
+// are direct-mapped by id into a fixed ring of slots; each slot packs the id
+// and its count into a single atomic word, so updates need no lock and a new
+// request only ever displaces the one sharing its slot.
+class HTTPSERedirectCounter {
+ public:
+  HTTPSERedirectCounter() {
+    for (auto& slot : slots_)
+      slot.store(0, std::memory_order_relaxed);
+  }
+
+  unsigned int Get(uint64_t request_identifier) const {
+    const uint64_t packed =
+        slots_[SlotFor(request_identifier)].load(std::memory_order_acquire);
+    if ((packed >> kCountBits) != Tag(request_identifier))
+      return 0;
+    return static_cast<unsigned int>(packed & kCountMask);
+  }
+
+  void Increment(uint64_t request_identifier) {
+    std::atomic<uint64_t>& slot = slots_[SlotFor(request_identifier)];
+    uint64_t packed = slot.load(std::memory_order_relaxed);
+    uint64_t updated;
+    do {
+      if ((packed >> kCountBits) == Tag(request_identifier)) {
+        const uint64_t count = packed & kCountMask;
+        updated = packed + (count < kCountMask ? 1 : 0);
+      } else {
+        updated = (Tag(request_identifier) << kCountBits) | 1;
+      }
+    } while (!slot.compare_exchange_weak(packed, updated,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_relaxed));
+  }
+
+ private:
+  static constexpr size_t kSlotCount = 64;
+  static constexpr uint64_t kCountBits = 4;
+  static constexpr uint64_t kCountMask = (1 << kCountBits) - 1;
+
+  // Request ids start at 1, so a zeroed slot never matches a real request.
+  static uint64_t Tag(uint64_t request_identifier) {
+    return request_identifier & (~uint64_t(0) >> kCountBits);
+  }
+
+  static size_t SlotFor(uint64_t request_identifier) {
+    return std::hash<uint64_t>()(request_identifier) % kSlotCount;
+  }
+
+  std::atomic<uint64_t> slots_[kSlotCount];
 };
 
 #endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RECENTLY_USED_CACHE_H_
@@ -28,3 +28,55 @@ TEST(HTTPSEverywhereRecentlyUsedCacheTest, Operations) {
   cache.remove("kD");
   ASSERT_FALSE(cache.get("kD", &v));
 }
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, ShardedOperations) {
+  using Cache = HTTPSERecentlyUsedCache<std::string>;
+  Cache cache(1024);
+
+  for (int i = 0; i < 512; ++i)
+    cache.add("k" + std::to_string(i), "v" + std::to_string(i));
+
+  std::string v;
+  for (int i = 0; i < 512; ++i) {
+    ASSERT_TRUE(cache.get("k" + std::to_string(i), &v));
+    ASSERT_EQ("v" + std::to_string(i), v);
+  }
+
+  cache.add("k0", "updated");
+  ASSERT_TRUE(cache.get("k0", &v));
+  ASSERT_EQ("updated", v);
+
+  cache.remove("k0");
+  ASSERT_FALSE(cache.get("k0", &v));
+}
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, TinySizes) {
+  using Cache = HTTPSERecentlyUsedCache<std::string>;
+  for (size_t size = 1; size <= 17; ++size) {
+    Cache cache(size);
+    for (int i = 0; i < 64; ++i)
+      cache.add("k" + std::to_string(i), "v" + std::to_string(i));
+
+    // The entry added last is never the one evicted.
+    std::string v;
+    ASSERT_TRUE(cache.get("k63", &v)) << "size " << size;
+    ASSERT_EQ("v63", v);
+  }
+}
+
+TEST(HTTPSEverywhereRedirectCounterTest, CountsPerRequest) {
+  HTTPSERedirectCounter counter;
+  EXPECT_EQ(0u, counter.Get(1));
+
+  counter.Increment(1);
+  counter.Increment(1);
+  counter.Increment(2);
+  EXPECT_EQ(2u, counter.Get(1));
+  EXPECT_EQ(1u, counter.Get(2));
+  EXPECT_EQ(0u, counter.Get(3));
+
+  // The count saturates instead of wrapping around.
+  for (int i = 0; i < 100; ++i)
+    counter.Increment(2);
+  EXPECT_EQ(15u, counter.Get(2));
+}
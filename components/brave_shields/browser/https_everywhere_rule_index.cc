@@ -0,0 +1,239 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_index.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/logging.h"
+#include "base/values.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+#include "third_party/leveldatabase/src/include/leveldb/iterator.h"
+
+namespace brave_shields {
+
+namespace {
+
+// HTTPS Everywhere uses JavaScript style "$1" back-references, RE2 wants
+// "\1".
+std::string CorrecttoRuleToRE2Engine(const std::string& to) {
+  std::string correctedto(to);
+  size_t pos = to.find("$");
+  while (std::string::npos != pos) {
+    correctedto[pos] = '\\';
+    pos = correctedto.find("$");
+  }
+
+  return correctedto;
+}
+
+}  // namespace
+
+HTTPSEverywhereRuleIndex::Rule::Rule() = default;
+HTTPSEverywhereRuleIndex::Rule::Rule(Rule&& other) = default;
+HTTPSEverywhereRuleIndex::Rule::~Rule() = default;
+
+HTTPSEverywhereRuleIndex::RuleSet::RuleSet() = default;
+HTTPSEverywhereRuleIndex::RuleSet::RuleSet(RuleSet&& other) = default;
+HTTPSEverywhereRuleIndex::RuleSet::~RuleSet() = default;
+
+HTTPSEverywhereRuleIndex::Target::Target() = default;
+HTTPSEverywhereRuleIndex::Target::~Target() = default;
+
+HTTPSEverywhereRuleIndex::HTTPSEverywhereRuleIndex() {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+HTTPSEverywhereRuleIndex::~HTTPSEverywhereRuleIndex() = default;
+
+// static
+std::unique_ptr<HTTPSEverywhereRuleIndex>
+HTTPSEverywhereRuleIndex::CreateFromDB(leveldb::DB* db) {
+  if (!db)
+    return nullptr;
+
+  auto index = std::make_unique<HTTPSEverywhereRuleIndex>();
+  std::unique_ptr<leveldb::Iterator> it(
+      db->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next()) {
+    index->AddTarget(it->key().ToString(), it->value().ToString());
+  }
+  if (!it->status().ok()) {
+    LOG(ERROR) << "HTTPS Everywhere database read error: "
+               << it->status().ToString();
+    return nullptr;
+  }
+
+  index->targets_by_json_.clear();
+  return index;
+}
+
+void HTTPSEverywhereRuleIndex::AddTarget(const std::string& key,
+                                         const std::string& rule_json) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (rule_json.empty())
+    return;
+
+  auto interned = targets_by_json_.find(rule_json);
+  if (interned != targets_by_json_.end()) {
+    targets_by_key_[key] = interned->second;
+    return;
+  }
+
+  targets_.push_back(ParseTarget(rule_json));
+  Target* target = targets_.back().get();
+  targets_by_json_[rule_json] = target;
+  targets_by_key_[key] = target;
+}
+
+std::string HTTPSEverywhereRuleIndex::ApplyRules(const std::string& key,
+                                                 const std::string& url) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = targets_by_key_.find(key);
+  if (it == targets_by_key_.end())
+    return "";
+
+  Target* target = it->second;
+  if (!target->compiled)
+    CompileTarget(target);
+
+  for (const auto& ruleset : target->rulesets) {
+    if (IsExcluded(ruleset, url))
+      return "";
+
+    if (!ruleset.has_rules)
+      return "";
+
+    for (const auto& rule : ruleset.rules) {
+      if (rule.is_default) {
+        std::string new_url(url);
+        return new_url.insert(4, "s");
+      }
+
+      if (!rule.from_regex->ok())
+        continue;
+
+      std::string new_url(url);
+      if (RE2::Replace(&new_url, *rule.from_regex, rule.to) &&
+          new_url != url) {
+        return new_url;
+      }
+    }
+  }
+  return "";
+}
+
+// static
+std::unique_ptr<HTTPSEverywhereRuleIndex::Target>
+HTTPSEverywhereRuleIndex::ParseTarget(const std::string& rule_json) {
+  auto target = std::make_unique<Target>();
+
+  absl::optional<base::Value> json_object = base::JSONReader::Read(rule_json);
+  if (!json_object || !json_object->is_list())
+    return target;
+
+  for (const auto& top_value : json_object->GetList()) {
+    if (!top_value.is_dict())
+      continue;
+
+    RuleSet ruleset;
+    const base::Value* exclusions = top_value.FindListKey("e");
+    if (exclusions) {
+      for (const auto& exclusion : exclusions->GetList()) {
+        if (!exclusion.is_dict())
+          continue;
+        const std::string* pattern = exclusion.FindStringKey("p");
+        if (pattern)
+          ruleset.exclusions.push_back(CorrecttoRuleToRE2Engine(*pattern));
+      }
+    }
+
+    const base::Value* rules = top_value.FindListKey("r");
+    if (rules) {
+      ruleset.has_rules = true;
+      for (const auto& rule_value : rules->GetList()) {
+        if (!rule_value.is_dict())
+          continue;
+        Rule rule;
+        if (rule_value.FindKey("d")) {
+          rule.is_default = true;
+        } else {
+          const std::string* from = rule_value.FindStringKey("f");
+          const std::string* to = rule_value.FindStringKey("t");
+          if (!from || !to)
+            continue;
+          rule.from = *from;
+          rule.to = CorrecttoRuleToRE2Engine(*to);
+        }
+        ruleset.rules.push_back(std::move(rule));
+      }
+    }
+
+    const bool has_rules = ruleset.has_rules;
+    target->rulesets.push_back(std::move(ruleset));
+    // Nothing after a ruleset without rules can be reached.
+    if (!has_rules)
+      break;
+  }
+
+  return target;
+}
+
+// static
+bool HTTPSEverywhereRuleIndex::IsExcluded(const RuleSet& ruleset,
+                                          const std::string& url) {
+  if (ruleset.exclusions.empty())
+    return false;
+
+  if (ruleset.exclusion_set) {
+    re2::RE2::Set::ErrorInfo error_info;
+    if (ruleset.exclusion_set->Match(url, nullptr, &error_info))
+      return true;
+    if (error_info.kind == re2::RE2::Set::kNoError)
+      return false;
+    LOG(ERROR) << "HTTPS Everywhere exclusion set match error: "
+               << error_info.kind;
+  }
+
+  // The set could not be compiled or ran out of memory, so fall back to
+  // matching each exclusion on its own.
+  for (const auto& exclusion : ruleset.exclusions) {
+    if (RE2::FullMatch(url, exclusion))
+      return true;
+  }
+
+  return false;
+}
+
+// static
+void HTTPSEverywhereRuleIndex::CompileTarget(Target* target) {
+  for (auto& ruleset : target->rulesets) {
+    if (!ruleset.exclusions.empty()) {
+      auto exclusion_set = std::make_unique<re2::RE2::Set>(
+          RE2::DefaultOptions, RE2::ANCHOR_BOTH);
+      bool added = false;
+      for (const auto& exclusion : ruleset.exclusions) {
+        // Patterns that fail to compile never matched before either.
+        if (exclusion_set->Add(exclusion, nullptr) != -1)
+          added = true;
+      }
+      // |exclusions| is kept for when the set is unusable.
+      if (added && exclusion_set->Compile())
+        ruleset.exclusion_set = std::move(exclusion_set);
+    }
+
+    for (auto& rule : ruleset.rules) {
+      if (!rule.is_default) {
+        rule.from_regex = std::make_unique<re2::RE2>(rule.from);
+        rule.from.clear();
+        rule.from.shrink_to_fit();
+      }
+    }
+  }
+  target->compiled = true;
+}
+
+}  // namespace brave_shields
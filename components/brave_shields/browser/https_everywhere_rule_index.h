@@ -0,0 +1,98 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_INDEX_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_INDEX_H_
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/sequence_checker.h"
+#include "third_party/re2/src/re2/re2.h"
+#include "third_party/re2/src/re2/set.h"
+
+namespace leveldb {
+class DB;
+}
+
+namespace brave_shields {
+
+// In-memory index of the HTTPS Everywhere rules, built once when the
+// component database is unpacked. Rule JSON is parsed at build time and hosts
+// that share the same rules share a single parsed copy, so lookups never touch
+// leveldb or the JSON reader. The regexes of a ruleset are compiled the first
+// time it is used and reused afterwards.
+class HTTPSEverywhereRuleIndex {
+ public:
+  HTTPSEverywhereRuleIndex();
+  ~HTTPSEverywhereRuleIndex();
+
+  // Reads every entry from |db|. Returns nullptr if |db| is null.
+  static std::unique_ptr<HTTPSEverywhereRuleIndex> CreateFromDB(
+      leveldb::DB* db);
+
+  // |key| is a reversed lookup domain as stored in the component database,
+  // e.g. "com.example" or "com.example.*".
+  void AddTarget(const std::string& key, const std::string& rule_json);
+
+  // Returns the HTTPS URL for |url| according to the rules stored under
+  // |key|, or an empty string if there is no such key or no rule applies.
+  std::string ApplyRules(const std::string& key, const std::string& url);
+
+  size_t size() const { return targets_by_key_.size(); }
+
+ private:
+  struct Rule {
+    Rule();
+    Rule(Rule&& other);
+    ~Rule();
+
+    // Rules marked with "d" only upgrade the scheme.
+    bool is_default = false;
+    std::string from;
+    std::string to;
+    std::unique_ptr<re2::RE2> from_regex;
+  };
+
+  struct RuleSet {
+    RuleSet();
+    RuleSet(RuleSet&& other);
+    ~RuleSet();
+
+    std::vector<std::string> exclusions;
+    std::unique_ptr<re2::RE2::Set> exclusion_set;
+    // A ruleset without a valid "r" list ends the lookup for its target.
+    bool has_rules = false;
+    std::vector<Rule> rules;
+  };
+
+  struct Target {
+    Target();
+    ~Target();
+
+    std::vector<RuleSet> rulesets;
+    bool compiled = false;
+  };
+
+  static std::unique_ptr<Target> ParseTarget(const std::string& rule_json);
+  static bool IsExcluded(const RuleSet& ruleset, const std::string& url);
+  static void CompileTarget(Target* target);
+
+  std::unordered_map<std::string, Target*> targets_by_key_;
+  // Only used while the index is being built, to share identical targets.
+  std::unordered_map<std::string, Target*> targets_by_json_;
+  std::vector<std::unique_ptr<Target>> targets_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSEverywhereRuleIndex);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_INDEX_H_
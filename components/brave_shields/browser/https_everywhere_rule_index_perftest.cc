@@ -0,0 +1,139 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/scoped_temp_dir.h"
+#include "base/json/json_reader.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/bind.h"
+#include "base/values.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_index.h"
+#include "brave/test/base/perf_test_util.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kMetricPrefix[] = "HTTPSEverywhereLookup.";
+constexpr char kMetricPerUrl[] = "per_url";
+
+constexpr int kHostCount = 20000;
+constexpr int kUrlCount = 2000;
+
+std::string RuleForHost(int i) {
+  return base::StringPrintf(
+      R"([{"e":[{"p":"^http://site%d\\.example\\.com/plain/.*"}],)"
+      R"("r":[{"f":"^http://(www\\.)?site%d\\.example\\.com/",)"
+      R"("t":"https://$1site%d.example.com/"}]}])",
+      i, i, i);
+}
+
+std::vector<std::string> BuildUrls() {
+  std::vector<std::string> urls;
+  for (int i = 0; i < kUrlCount; ++i) {
+    urls.push_back(base::StringPrintf("http://www.site%d.example.com/a/%d",
+                                      (i * 7919) % kHostCount, i));
+  }
+  return urls;
+}
+
+std::string LookupKey(const std::string& url) {
+  // "http://www.siteN.example.com/..." is stored under "com.example.siteN".
+  const size_t host_start = url.find("site");
+  const size_t host_end = url.find('.', host_start);
+  return "com.example." + url.substr(host_start, host_end - host_start);
+}
+
+// What the service did per lookup before the index existed: read the rule
+// string from leveldb, parse it, and compile its regexes.
+std::string LegacyLookup(leveldb::DB* db, const std::string& url) {
+  std::string rule;
+  if (!db->Get(leveldb::ReadOptions(), LookupKey(url), &rule).ok())
+    return "";
+  absl::optional<base::Value> json = base::JSONReader::Read(rule);
+  if (!json || !json->is_list())
+    return "";
+  for (const auto& ruleset : json->GetList()) {
+    const base::Value* exclusions = ruleset.FindListKey("e");
+    if (exclusions) {
+      for (const auto& exclusion : exclusions->GetList()) {
+        const std::string* pattern = exclusion.FindStringKey("p");
+        if (pattern && RE2::FullMatch(url, *pattern))
+          return "";
+      }
+    }
+    const base::Value* rules = ruleset.FindListKey("r");
+    if (!rules)
+      return "";
+    for (const auto& r : rules->GetList()) {
+      const std::string* from = r.FindStringKey("f");
+      const std::string* to = r.FindStringKey("t");
+      if (!from || !to)
+        continue;
+      std::string corrected_to(*to);
+      for (auto& c : corrected_to) {
+        if (c == '$')
+          c = '\\';
+      }
+      std::string new_url(url);
+      if (RE2::Replace(&new_url, RE2(*from), corrected_to) && new_url != url)
+        return new_url;
+    }
+  }
+  return "";
+}
+
+}  // namespace
+
+class HTTPSEverywhereRuleIndexPerfTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+    leveldb::Options options;
+    options.create_if_missing = true;
+    leveldb::DB* db = nullptr;
+    ASSERT_TRUE(leveldb::DB::Open(options,
+                                  temp_dir_.GetPath().AsUTF8Unsafe(), &db)
+                    .ok());
+    db_.reset(db);
+    for (int i = 0; i < kHostCount; ++i) {
+      db_->Put(leveldb::WriteOptions(),
+               base::StringPrintf("com.example.site%d", i), RuleForHost(i));
+    }
+    urls_ = BuildUrls();
+  }
+
+  base::ScopedTempDir temp_dir_;
+  std::unique_ptr<leveldb::DB> db_;
+  std::vector<std::string> urls_;
+};
+
+TEST_F(HTTPSEverywhereRuleIndexPerfTest, LevelDBLookup) {
+  brave::RunPerfTest(kMetricPrefix, kMetricPerUrl, "leveldb", urls_.size(),
+                     base::BindLambdaForTesting([&]() {
+                       for (const auto& url : urls_)
+                         EXPECT_FALSE(LegacyLookup(db_.get(), url).empty());
+                     }));
+}
+
+TEST_F(HTTPSEverywhereRuleIndexPerfTest, RuleIndexLookup) {
+  auto index = HTTPSEverywhereRuleIndex::CreateFromDB(db_.get());
+  ASSERT_TRUE(index);
+
+  brave::RunPerfTest(
+      kMetricPrefix, kMetricPerUrl, "rule_index", urls_.size(),
+      base::BindLambdaForTesting([&]() {
+        for (const auto& url : urls_)
+          EXPECT_FALSE(index->ApplyRules(LookupKey(url), url).empty());
+      }));
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,66 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string>
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_index.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+TEST(HTTPSEverywhereRuleIndexTest, DefaultRule) {
+  HTTPSEverywhereRuleIndex index;
+  index.AddTarget("com.example", R"([{"r":[{"d":1}]}])");
+
+  EXPECT_EQ("https://example.com/",
+            index.ApplyRules("com.example", "http://example.com/"));
+  EXPECT_EQ("", index.ApplyRules("com.example.*", "http://example.com/"));
+}
+
+TEST(HTTPSEverywhereRuleIndexTest, RewriteRule) {
+  HTTPSEverywhereRuleIndex index;
+  index.AddTarget(
+      "com.example.*",
+      R"([{"r":[{"f":"^http://(\\w+)\\.example\\.com/",)"
+      R"("t":"https://$1.example.com/"}]}])");
+
+  EXPECT_EQ("https://www.example.com/a",
+            index.ApplyRules("com.example.*", "http://www.example.com/a"));
+  // The rule does not change this URL.
+  EXPECT_EQ("", index.ApplyRules("com.example.*", "http://example.org/"));
+}
+
+TEST(HTTPSEverywhereRuleIndexTest, Exclusions) {
+  HTTPSEverywhereRuleIndex index;
+  index.AddTarget("com.example",
+                  R"([{"e":[{"p":"^http://example\\.com/insecure/.*"}],)"
+                  R"("r":[{"d":1}]}])");
+
+  EXPECT_EQ("", index.ApplyRules("com.example",
+                                 "http://example.com/insecure/page"));
+  EXPECT_EQ("https://example.com/secure",
+            index.ApplyRules("com.example", "http://example.com/secure"));
+}
+
+TEST(HTTPSEverywhereRuleIndexTest, MissingRulesStopsLookup) {
+  HTTPSEverywhereRuleIndex index;
+  index.AddTarget("com.example", R"([{"e":[]},{"r":[{"d":1}]}])");
+
+  EXPECT_EQ("", index.ApplyRules("com.example", "http://example.com/"));
+}
+
+TEST(HTTPSEverywhereRuleIndexTest, SharedTargets) {
+  HTTPSEverywhereRuleIndex index;
+  index.AddTarget("com.example", R"([{"r":[{"d":1}]}])");
+  index.AddTarget("org.example", R"([{"r":[{"d":1}]}])");
+  index.AddTarget("net.example", "not json");
+
+  EXPECT_EQ(3u, index.size());
+  EXPECT_EQ("https://example.org/",
+            index.ApplyRules("org.example", "http://example.org/"));
+  EXPECT_EQ("", index.ApplyRules("net.example", "http://example.net/"));
+}
+
+}  // namespace brave_shields
@@ -12,21 +12,17 @@
 
 #include "base/base_paths.h"
 #include "base/bind.h"
-#include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
-#include "base/values.h"
 #include "third_party/leveldatabase/src/include/leveldb/db.h"
-#include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
 #define DAT_FILE_VERSION "6.0"
-#define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1
 #define HTTPSE_URL_MAX_REDIRECTS_COUNT      5
 
 namespace {
@@ -66,16 +62,6 @@ std::vector<std::string> ExpandDomainForLookup(const std::string& domain) {
   }
   return resultDomains;
 }
-std::string leveldbGet(leveldb::DB* db, const std::string &key) {
-  if (!db) {
-    return "";
-  }
-
-  std::string value;
-  leveldb::Status s = db->Get(leveldb::ReadOptions(), key, &value);
-  return s.ok() ? value : "";
-}
-
 }  // namespace
 
 namespace brave_shields {
@@ -100,13 +86,12 @@ HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
 
 HTTPSEverywhereService::HTTPSEverywhereService(
     BraveComponent::Delegate* delegate)
-    : BaseBraveShieldsService(delegate),
-      level_db_(nullptr) {
+    : BaseBraveShieldsService(delegate) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 HTTPSEverywhereService::~HTTPSEverywhereService() {
-  GetTaskRunner()->DeleteSoon(FROM_HERE, level_db_);
+  GetTaskRunner()->DeleteSoon(FROM_HERE, std::move(rule_index_));
 }
 
 bool HTTPSEverywhereService::Init() {
@@ -128,20 +113,31 @@ void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
     return;
   }
 
-  CloseDatabase();
-
+  leveldb::DB* level_db = nullptr;
   leveldb::Options options;
   leveldb::Status status =
       leveldb::DB::Open(options,
                         unzipped_level_db_path.AsUTF8Unsafe(),
-                        &level_db_);
-  if (!status.ok() || !level_db_) {
+                        &level_db);
+  if (!status.ok() || !level_db) {
     LOG(ERROR) << "Level db open error "
                << unzipped_level_db_path.value().c_str()
                << ", error: " << status.ToString();
-    CloseDatabase();
+    delete level_db;
     return;
   }
+
+  // The database is only read once, up front. Lookups are then served from
+  // the in-memory index without parsing rule JSON on every request.
+  std::unique_ptr<leveldb::DB> db(level_db);
+  SCOPED_UMA_HISTOGRAM_TIMER("Brave.HTTPSE.BuildRuleIndex");
+  auto rule_index = HTTPSEverywhereRuleIndex::CreateFromDB(db.get());
+  if (!rule_index) {
+    LOG(ERROR) << "Failed to build HTTPS Everywhere rule index from "
+               << unzipped_level_db_path.value().c_str();
+    return;
+  }
+  rule_index_ = std::move(rule_index);
 }
 
 void HTTPSEverywhereService::OnComponentReady(
@@ -162,7 +158,8 @@ bool HTTPSEverywhereService::GetHTTPSURL(
   if (!url->is_valid())
     return false;
 
-  if (!IsInitialized() || !level_db_ || url->scheme() == url::kHttpsScheme) {
+  if (!IsInitialized() || !rule_index_ ||
+      url->scheme() == url::kHttpsScheme) {
     return false;
   }
   if (!ShouldHTTPSERedirect(request_identifier)) {
@@ -184,15 +181,12 @@ bool HTTPSEverywhereService::GetHTTPSURL(
   SCOPED_UMA_HISTOGRAM_TIMER("Brave.HTTPSE.GetHTTPSURL");
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
-  for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
-    if (!value.empty()) {
-      *new_url = ApplyHTTPSRule(candidate_url.spec(), value);
-      if (0 != new_url->length()) {
-        recently_used_cache_.add(candidate_url.spec(), *new_url);
-        AddHTTPSEUrlToRedirectList(request_identifier);
-        return true;
-      }
+  for (const auto& domain : domains) {
+    *new_url = rule_index_->ApplyRules(domain, candidate_url.spec());
+    if (0 != new_url->length()) {
+      recently_used_cache_.add(candidate_url.spec(), *new_url);
+      AddHTTPSEUrlToRedirectList(request_identifier);
+      return true;
     }
   }
   recently_used_cache_.remove(candidate_url.spec());
@@ -222,164 +216,14 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
 
 bool HTTPSEverywhereService::ShouldHTTPSERedirect(
     const uint64_t& request_identifier) {
-  base::AutoLock auto_lock(httpse_get_urls_redirects_count_mutex_);
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_ &&
-        httpse_urls_redirects_count_[i].redirects_ >=
-        HTTPSE_URL_MAX_REDIRECTS_COUNT - 1) {
-      return false;
-    }
-  }
-
-  return true;
+  return redirect_counter_.Get(request_identifier) <
+         HTTPSE_URL_MAX_REDIRECTS_COUNT - 1;
 }
 
 void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
     const uint64_t& request_identifier) {
   // Adding redirects count for the current request
-  base::AutoLock auto_lock(httpse_get_urls_redirects_count_mutex_);
-  bool hostFound = false;
-  for (size_t i = 0; i < httpse_urls_redirects_count_.size(); i++) {
-    if (request_identifier ==
-        httpse_urls_redirects_count_[i].request_identifier_) {
-      // Found the host, just increment the redirects_count
-      httpse_urls_redirects_count_[i].redirects_++;
-      hostFound = true;
-      break;
-    }
-  }
-  if (!hostFound) {
-      // The host is new, adding it to the redirects list
-      if (httpse_urls_redirects_count_.size() >=
-          HTTPSE_URLS_REDIRECTS_COUNT_QUEUE) {
-          // The queue is full, erase the first element
-          httpse_urls_redirects_count_.erase(
-              httpse_urls_redirects_count_.begin());
-      }
-      httpse_urls_redirects_count_.push_back(
-          HTTPSE_REDIRECTS_COUNT_ST(request_identifier, 1));
-  }
-}
-
-std::string HTTPSEverywhereService::ApplyHTTPSRule(
-    const std::string& originalUrl,
-    const std::string& rule) {
-  absl::optional<base::Value> json_object = base::JSONReader::Read(rule);
-  if (absl::nullopt == json_object || !json_object->is_list()) {
-    return "";
-  }
-
-  base::Value::ConstListView topValues = json_object->GetList();
-  for (auto it = topValues.cbegin(); it != topValues.cend(); ++it) {
-    if (!it->is_dict()) {
-      continue;
-    }
-    const base::DictionaryValue* childTopDictionary = nullptr;
-    it->GetAsDictionary(&childTopDictionary);
-    if (nullptr == childTopDictionary) {
-      continue;
-    }
-
-    const base::Value* exclusion = nullptr;
-    if (childTopDictionary->Get("e", &exclusion)) {
-      const base::ListValue* eValues = nullptr;
-      exclusion->GetAsList(&eValues);
-      if (nullptr != eValues) {
-        for (size_t j = 0; j < eValues->GetSize(); ++j) {
-          const base::Value* pValue = nullptr;
-          if (!eValues->Get(j, &pValue)) {
-            continue;
-          }
-          const base::DictionaryValue* pDictionary = nullptr;
-          pValue->GetAsDictionary(&pDictionary);
-          if (nullptr == pDictionary) {
-            continue;
-          }
-          const base::Value* patternValue = nullptr;
-          if (!pDictionary->Get("p", &patternValue)) {
-            continue;
-          }
-          std::string pattern;
-          if (!patternValue->GetAsString(&pattern)) {
-            continue;
-          }
-          pattern = CorrecttoRuleToRE2Engine(pattern);
-          if (RE2::FullMatch(originalUrl, pattern)) {
-            return "";
-          }
-        }
-      }
-    }
-
-    const base::Value* rules = nullptr;
-    if (!childTopDictionary->Get("r", &rules)) {
-      return "";
-    }
-    const base::ListValue* rValues = nullptr;
-    rules->GetAsList(&rValues);
-    if (nullptr == rValues) {
-      return "";
-    }
-
-    for (size_t j = 0; j < rValues->GetSize(); ++j) {
-      const base::Value* pValue = nullptr;
-      if (!rValues->Get(j, &pValue)) {
-        continue;
-      }
-      const base::DictionaryValue* pDictionary = nullptr;
-      pValue->GetAsDictionary(&pDictionary);
-      if (nullptr == pDictionary) {
-        continue;
-      }
-      const base::Value* patternValue = nullptr;
-      if (pDictionary->Get("d", &patternValue)) {
-        std::string newUrl(originalUrl);
-        return newUrl.insert(4, "s");
-      }
-
-      const base::Value* from_value = nullptr;
-      const base::Value* to_value = nullptr;
-      if (!pDictionary->Get("f", &from_value) ||
-          !pDictionary->Get("t", &to_value)) {
-        continue;
-      }
-      std::string from, to;
-      if (!from_value->GetAsString(&from) ||
-          !to_value->GetAsString(&to)) {
-        continue;
-      }
-
-      to = CorrecttoRuleToRE2Engine(to);
-      std::string newUrl(originalUrl);
-      RE2 regExp(from);
-
-      if (RE2::Replace(&newUrl, regExp, to) && newUrl != originalUrl) {
-        return newUrl;
-      }
-    }
-  }
-  return "";
-}
-
-std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
-    const std::string& to) {
-  std::string correctedto(to);
-  size_t pos = to.find("$");
-  while (std::string::npos != pos) {
-    correctedto[pos] = '\\';
-    pos = correctedto.find("$");
-  }
-
-  return correctedto;
-}
-
-void HTTPSEverywhereService::CloseDatabase() {
-  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  if (level_db_) {
-    delete level_db_;
-    level_db_ = nullptr;
-  }
+  redirect_counter_.Increment(request_identifier);
 }
 
 // static
@@ -0,0 +1,89 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_settings_snapshot.h"
+
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr size_t kMaxSnapshots = 64;
+
+bool IsShieldsContentSettingsType(ContentSettingsType content_type) {
+  switch (content_type) {
+    case ContentSettingsType::BRAVE_SHIELDS:
+    case ContentSettingsType::BRAVE_ADS:
+    case ContentSettingsType::BRAVE_TRACKERS:
+    case ContentSettingsType::BRAVE_COSMETIC_FILTERING:
+    case ContentSettingsType::BRAVE_HTTP_UPGRADABLE_RESOURCES:
+    case ContentSettingsType::BRAVE_REFERRERS:
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+ShieldsSettingsSnapshot::ShieldsSettingsSnapshot(HostContentSettingsMap* map,
+                                                 const GURL& tab_origin,
+                                                 uint64_t version)
+    : tab_origin(tab_origin),
+      version(version),
+      allow_brave_shields(GetBraveShieldsEnabled(map, tab_origin)),
+      allow_ads(GetAdControlType(map, tab_origin) == ControlType::ALLOW),
+      // Currently, "aggressive" mode is registered as a cosmetic filtering
+      // control type, even though it can also affect network blocking.
+      aggressive_blocking(GetCosmeticFilteringControlType(map, tab_origin) ==
+                          ControlType::BLOCK),
+      allow_http_upgradable_resource(
+          !GetHTTPSEverywhereEnabled(map, tab_origin)),
+      allow_referrers(AllowReferrers(map, tab_origin)) {}
+
+ShieldsSettingsSnapshot::~ShieldsSettingsSnapshot() = default;
+
+ShieldsSettingsSnapshotService::ShieldsSettingsSnapshotService(
+    HostContentSettingsMap* map)
+    : map_(map), snapshots_(kMaxSnapshots) {
+  DCHECK(map_);
+  observation_.Observe(map_);
+}
+
+ShieldsSettingsSnapshotService::~ShieldsSettingsSnapshotService() = default;
+
+scoped_refptr<const ShieldsSettingsSnapshot>
+ShieldsSettingsSnapshotService::GetSnapshot(const GURL& tab_origin,
+                                            bool refresh) {
+  if (!refresh) {
+    auto it = snapshots_.Get(tab_origin);
+    if (it != snapshots_.end())
+      return it->second;
+  }
+
+  scoped_refptr<const ShieldsSettingsSnapshot> snapshot =
+      base::MakeRefCounted<ShieldsSettingsSnapshot>(map_, tab_origin,
+                                                    version_);
+  snapshots_.Put(tab_origin, snapshot);
+  return snapshot;
+}
+
+void ShieldsSettingsSnapshotService::Shutdown() {
+  observation_.Reset();
+  snapshots_.Clear();
+}
+
+void ShieldsSettingsSnapshotService::OnContentSettingChanged(
+    const ContentSettingsPattern& primary_pattern,
+    const ContentSettingsPattern& secondary_pattern,
+    ContentSettingsType content_type) {
+  if (!IsShieldsContentSettingsType(content_type))
+    return;
+  ++version_;
+  snapshots_.Clear();
+}
+
+}  // namespace brave_shields
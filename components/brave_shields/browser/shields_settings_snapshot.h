@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_SNAPSHOT_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_SNAPSHOT_H_
+
+#include <stdint.h>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/scoped_observation.h"
+#include "components/content_settings/core/browser/content_settings_observer.h"
+#include "components/content_settings/core/browser/host_content_settings_map.h"
+#include "components/keyed_service/core/keyed_service.h"
+#include "url/gurl.h"
+
+namespace brave_shields {
+
+// The shields settings that apply to every request made from a tab, resolved
+// once for the tab origin. Immutable, so it can be shared between requests
+// and read from any thread.
+struct ShieldsSettingsSnapshot
+    : public base::RefCountedThreadSafe<ShieldsSettingsSnapshot> {
+  ShieldsSettingsSnapshot(HostContentSettingsMap* map,
+                          const GURL& tab_origin,
+                          uint64_t version);
+
+  const GURL tab_origin;
+  // The ShieldsSettingsSnapshotService version this was computed at.
+  const uint64_t version;
+
+  const bool allow_brave_shields;
+  const bool allow_ads;
+  // Whether cosmetic filtering, and with it network blocking, is aggressive.
+  const bool aggressive_blocking;
+  const bool allow_http_upgradable_resource;
+  const bool allow_referrers;
+
+ private:
+  friend class base::RefCountedThreadSafe<ShieldsSettingsSnapshot>;
+  ~ShieldsSettingsSnapshot();
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldsSettingsSnapshot);
+};
+
+// Hands out ShieldsSettingsSnapshots for a profile. Snapshots are cached per
+// tab origin and dropped whenever a shields content setting changes, which
+// also bumps the version.
+class ShieldsSettingsSnapshotService : public KeyedService,
+                                       public content_settings::Observer {
+ public:
+  explicit ShieldsSettingsSnapshotService(HostContentSettingsMap* map);
+  ~ShieldsSettingsSnapshotService() override;
+
+  // Returns the snapshot for |tab_origin|. |refresh| recomputes it even if a
+  // cached one exists, which top-level navigations use so that every page
+  // load starts from the current settings.
+  scoped_refptr<const ShieldsSettingsSnapshot> GetSnapshot(
+      const GURL& tab_origin,
+      bool refresh);
+
+  uint64_t version() const { return version_; }
+
+  // KeyedService:
+  void Shutdown() override;
+
+ private:
+  // content_settings::Observer:
+  void OnContentSettingChanged(const ContentSettingsPattern& primary_pattern,
+                               const ContentSettingsPattern& secondary_pattern,
+                               ContentSettingsType content_type) override;
+
+  HostContentSettingsMap* map_;
+  uint64_t version_ = 0;
+  base::MRUCache<GURL, scoped_refptr<const ShieldsSettingsSnapshot>>
+      snapshots_;
+  base::ScopedObservation<HostContentSettingsMap, content_settings::Observer>
+      observation_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(ShieldsSettingsSnapshotService);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_SHIELDS_SETTINGS_SNAPSHOT_H_
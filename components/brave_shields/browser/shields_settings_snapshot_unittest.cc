@@ -0,0 +1,80 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/shields_settings_snapshot.h"
+
+#include <memory>
+
+#include "brave/components/brave_shields/browser/brave_shields_util.h"
+#include "chrome/browser/content_settings/host_content_settings_map_factory.h"
+#include "chrome/test/base/testing_profile.h"
+#include "content/public/test/browser_task_environment.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace brave_shields {
+
+class ShieldsSettingsSnapshotTest : public testing::Test {
+ public:
+  void SetUp() override {
+    profile_ = std::make_unique<TestingProfile>();
+    service_ = std::make_unique<ShieldsSettingsSnapshotService>(map());
+  }
+
+  void TearDown() override { service_->Shutdown(); }
+
+  HostContentSettingsMap* map() {
+    return HostContentSettingsMapFactory::GetForProfile(profile_.get());
+  }
+
+ protected:
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<TestingProfile> profile_;
+  std::unique_ptr<ShieldsSettingsSnapshotService> service_;
+};
+
+TEST_F(ShieldsSettingsSnapshotTest, MatchesContentSettings) {
+  const GURL origin("https://brave.com/");
+  SetAdControlType(map(), ControlType::ALLOW, origin);
+  SetHTTPSEverywhereEnabled(map(), false, origin);
+
+  auto snapshot = service_->GetSnapshot(origin, false);
+  EXPECT_TRUE(snapshot->allow_brave_shields);
+  EXPECT_TRUE(snapshot->allow_ads);
+  EXPECT_TRUE(snapshot->allow_http_upgradable_resource);
+  EXPECT_EQ(GetCosmeticFilteringControlType(map(), origin) ==
+                ControlType::BLOCK,
+            snapshot->aggressive_blocking);
+  EXPECT_EQ(AllowReferrers(map(), origin), snapshot->allow_referrers);
+
+  auto other = service_->GetSnapshot(GURL("https://example.com/"), false);
+  EXPECT_FALSE(other->allow_ads);
+  EXPECT_FALSE(other->allow_http_upgradable_resource);
+}
+
+TEST_F(ShieldsSettingsSnapshotTest, SharedUntilSettingsChange) {
+  const GURL origin("https://brave.com/");
+  auto snapshot = service_->GetSnapshot(origin, false);
+  EXPECT_EQ(snapshot, service_->GetSnapshot(origin, false));
+
+  const uint64_t version = service_->version();
+  SetBraveShieldsEnabled(map(), false, origin);
+  EXPECT_GT(service_->version(), version);
+
+  auto updated = service_->GetSnapshot(origin, false);
+  EXPECT_NE(snapshot, updated);
+  EXPECT_TRUE(snapshot->allow_brave_shields);
+  EXPECT_FALSE(updated->allow_brave_shields);
+  EXPECT_EQ(service_->version(), updated->version);
+}
+
+TEST_F(ShieldsSettingsSnapshotTest, RefreshRecomputes) {
+  const GURL origin("https://brave.com/");
+  auto snapshot = service_->GetSnapshot(origin, false);
+  auto refreshed = service_->GetSnapshot(origin, true);
+  EXPECT_NE(snapshot, refreshed);
+  EXPECT_EQ(refreshed, service_->GetSnapshot(origin, false));
+}
+
+}  // namespace brave_shields
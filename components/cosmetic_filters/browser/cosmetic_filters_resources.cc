@@ -7,9 +7,9 @@
 
 #include <utility>
 
-#include "base/json/json_reader.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
+#include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/browser/brave_shields_util.h"
 #include "components/content_settings/core/browser/host_content_settings_map.h"
 #include "third_party/abseil-cpp/absl/types/optional.h"
@@ -26,42 +26,16 @@ CosmeticFiltersResources::CosmeticFiltersResources(
 CosmeticFiltersResources::~CosmeticFiltersResources() {}
 
 void CosmeticFiltersResources::HiddenClassIdSelectors(
-    const std::string& input,
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions,
     HiddenClassIdSelectorsCallback callback) {
-  absl::optional<base::Value> input_value = base::JSONReader::Read(input);
-  if (!input_value || !input_value->is_dict()) {
+  if (classes.empty() && ids.empty()) {
     // Nothing to work with
-    std::move(callback).Run(base::Value());
+    std::move(callback).Run(std::vector<std::string>());
 
     return;
   }
-  base::DictionaryValue* input_dict;
-  if (!input_value->GetAsDictionary(&input_dict)) {
-    std::move(callback).Run(base::Value());
-
-    return;
-  }
-  std::vector<std::string> classes;
-  base::ListValue* classes_list;
-  if (input_dict->GetList("classes", &classes_list)) {
-    for (size_t i = 0; i < classes_list->GetSize(); i++) {
-      if (!classes_list->GetList()[i].is_string()) {
-        continue;
-      }
-      classes.push_back(classes_list->GetList()[i].GetString());
-    }
-  }
-  std::vector<std::string> ids;
-  base::ListValue* ids_list;
-  if (input_dict->GetList("ids", &ids_list)) {
-    for (size_t i = 0; i < ids_list->GetSize(); i++) {
-      if (!ids_list->GetList()[i].is_string()) {
-        continue;
-      }
-      ids.push_back(ids_list->GetList()[i].GetString());
-    }
-  }
 
   ad_block_service_->GetTaskRunner()->PostTaskAndReplyWithResult(
       FROM_HERE,
@@ -75,15 +49,42 @@ void CosmeticFiltersResources::HiddenClassIdSelectors(
 void CosmeticFiltersResources::HiddenClassIdSelectorsOnUI(
     HiddenClassIdSelectorsCallback callback,
     absl::optional<base::Value> resources) {
-  std::move(callback).Run(resources ? std::move(resources.value())
-                                    : base::Value());
+  std::vector<std::string> selectors;
+  if (resources && resources->is_list()) {
+    for (auto& entry : resources->GetList()) {
+      if (entry.is_string()) {
+        selectors.push_back(std::move(entry.GetString()));
+        continue;
+      }
+      // Without native cosmetic filtering the hide and custom selectors come
+      // back as two nested lists.
+      if (!entry.is_list())
+        continue;
+      for (auto& selector : entry.GetList()) {
+        if (selector.is_string())
+          selectors.push_back(std::move(selector.GetString()));
+      }
+    }
+  }
+  std::move(callback).Run(std::move(selectors));
 }
 
 void CosmeticFiltersResources::UrlCosmeticResourcesOnUI(
     UrlCosmeticResourcesCallback callback,
-    absl::optional<base::Value> resources) {
-  std::move(callback).Run(resources ? std::move(resources.value())
-                                    : base::Value());
+    brave_shields::CosmeticResources resources) {
+  auto result = mojom::CosmeticResources::New();
+  result->hide_selectors.assign(resources.hide_selectors.begin(),
+                                resources.hide_selectors.end());
+  result->force_hide_selectors.assign(resources.force_hide_selectors.begin(),
+                                      resources.force_hide_selectors.end());
+  for (auto& entry : resources.style_selectors) {
+    result->style_selectors.emplace(entry.first, std::move(entry.second));
+  }
+  result->exceptions.assign(resources.exceptions.begin(),
+                            resources.exceptions.end());
+  result->injected_script = std::move(resources.injected_script);
+  result->generichide = resources.generichide;
+  std::move(callback).Run(std::move(result));
 }
 
 void CosmeticFiltersResources::ShouldDoCosmeticFiltering(
@@ -100,6 +101,15 @@ void CosmeticFiltersResources::ShouldDoCosmeticFiltering(
 void CosmeticFiltersResources::UrlCosmeticResources(
     const std::string& url,
     UrlCosmeticResourcesCallback callback) {
+  // Subframes and repeat visits can usually be answered without waiting
+  // behind other work on the adblock task runner.
+  absl::optional<brave_shields::CosmeticResources> cached =
+      ad_block_service_->GetCachedUrlCosmeticResources(url);
+  if (cached) {
+    UrlCosmeticResourcesOnUI(std::move(callback), std::move(*cached));
+    return;
+  }
+
   ad_block_service_->GetTaskRunner()->PostTaskAndReplyWithResult(
       FROM_HERE,
       base::BindOnce(&brave_shields::AdBlockService::UrlCosmeticResources,
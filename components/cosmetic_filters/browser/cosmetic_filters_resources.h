@@ -19,6 +19,7 @@ class HostContentSettingsMap;
 
 namespace brave_shields {
 class AdBlockService;
+struct CosmeticResources;
 }
 
 namespace cosmetic_filters {
@@ -43,7 +44,8 @@ class CosmeticFiltersResources final
 
   // Sends back to renderer a response about rules that has to be applied
   // for the specified selectors.
-  void HiddenClassIdSelectors(const std::string& input,
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids,
                               const std::vector<std::string>& exceptions,
                               HiddenClassIdSelectorsCallback callback) override;
 
@@ -57,7 +59,7 @@ class CosmeticFiltersResources final
                                   absl::optional<base::Value> resources);
 
   void UrlCosmeticResourcesOnUI(UrlCosmeticResourcesCallback callback,
-                                absl::optional<base::Value> resources);
+                                brave_shields::CosmeticResources resources);
 
   HostContentSettingsMap* settings_map_;             // Not owned
   brave_shields::AdBlockService* ad_block_service_;  // Not owned
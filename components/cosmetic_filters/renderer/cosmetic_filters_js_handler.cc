@@ -8,16 +8,19 @@
 #include <utility>
 
 #include "base/bind.h"
-#include "base/json/json_writer.h"
+#include "base/containers/flat_map.h"
+#include "base/json/string_escape.h"
 #include "base/no_destructor.h"
 #include "base/strings/stringprintf.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/time/time.h"
 #include "brave/components/cosmetic_filters/resources/grit/cosmetic_filters_generated_map.h"
 #include "content/public/renderer/render_frame.h"
 #include "gin/arguments.h"
 #include "gin/function_template.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 #include "third_party/blink/public/common/browser_interface_broker_proxy.h"
+#include "third_party/blink/public/platform/task_type.h"
 #include "third_party/blink/public/web/blink.h"
 #include "third_party/blink/public/web/web_document.h"
 #include "third_party/blink/public/web/web_local_frame.h"
@@ -155,6 +158,58 @@ const char kStyleSelectorsInjectScript[] =
           };
         })();)";
 
+// Mutation observer callbacks arriving within roughly one animation frame of
+// each other are answered with a single browser round trip.
+constexpr base::TimeDelta kHiddenClassIdSelectorsBatchDelay =
+    base::TimeDelta::FromMilliseconds(16);
+
+// Adds the entries of |names| that haven't been queried yet to |pending|.
+void QueueNewNames(const std::vector<std::string>& names,
+                   const std::unordered_set<std::string>& queried,
+                   std::unordered_set<std::string>* pending) {
+  for (const auto& name : names) {
+    if (!name.empty() && queried.find(name) == queried.end())
+      pending->insert(name);
+  }
+}
+
+// Moves the names in |pending| into |queried| and returns them.
+std::vector<std::string> TakePendingNames(
+    std::unordered_set<std::string>* pending,
+    std::unordered_set<std::string>* queried) {
+  std::vector<std::string> names(pending->begin(), pending->end());
+  queried->insert(pending->begin(), pending->end());
+  pending->clear();
+  return names;
+}
+
+std::string SelectorsToJSONArray(const std::vector<std::string>& selectors) {
+  std::string json = "[";
+  for (const auto& selector : selectors) {
+    if (json.size() > 1)
+      json += ",";
+    base::EscapeJSONString(selector, true, &json);
+  }
+  json += "]";
+  return json;
+}
+
+// Builds a JSON object mapping each selector to its list of styles.
+std::string StyleSelectorsToJSONObject(
+    const base::flat_map<std::string, std::vector<std::string>>&
+        style_selectors) {
+  std::string json = "{";
+  for (const auto& entry : style_selectors) {
+    if (json.size() > 1)
+      json += ",";
+    base::EscapeJSONString(entry.first, true, &json);
+    json += ":";
+    json += SelectorsToJSONArray(entry.second);
+  }
+  json += "}";
+  return json;
+}
+
 std::string LoadDataResource(const int id) {
   auto& resource_bundle = ui::ResourceBundle::GetSharedInstance();
   if (resource_bundle.IsGzipped(id)) {
@@ -202,12 +257,37 @@ CosmeticFiltersJSHandler::CosmeticFiltersJSHandler(
 CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() = default;
 
 void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
-    const std::string& input) {
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids) {
+  QueueNewNames(classes, queried_classes_, &pending_classes_);
+  QueueNewNames(ids, queried_ids_, &pending_ids_);
+  if (flush_scheduled_ || (pending_classes_.empty() && pending_ids_.empty()))
+    return;
+
+  flush_scheduled_ = true;
+  render_frame_->GetTaskRunner(blink::TaskType::kInternalDefault)
+      ->PostDelayedTask(
+          FROM_HERE,
+          base::BindOnce(
+              &CosmeticFiltersJSHandler::FlushHiddenClassIdSelectors,
+              weak_ptr_factory_.GetWeakPtr()),
+          kHiddenClassIdSelectorsBatchDelay);
+}
+
+void CosmeticFiltersJSHandler::FlushHiddenClassIdSelectors() {
+  flush_scheduled_ = false;
+  // ProcessURL may have dropped the queue since the flush was scheduled.
+  if (pending_classes_.empty() && pending_ids_.empty())
+    return;
+
+  // Names stay queued if there is no connection, and go out with the next
+  // batch.
   if (!EnsureConnected())
     return;
 
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      TakePendingNames(&pending_classes_, &queried_classes_),
+      TakePendingNames(&pending_ids_, &queried_ids_), exceptions_,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
                      base::Unretained(this)));
 }
@@ -286,7 +366,11 @@ void CosmeticFiltersJSHandler::OnRemoteDisconnect() {
 
 void CosmeticFiltersJSHandler::ProcessURL(const GURL& url,
                                           base::OnceClosure callback) {
-  resources_dict_.reset();
+  resources_.reset();
+  queried_classes_.clear();
+  queried_ids_.clear();
+  pending_classes_.clear();
+  pending_ids_.clear();
   url_ = url;
   // Trivially, don't make exceptions for malformed URLs.
   if (!EnsureConnected() || url_.is_empty() || !url_.is_valid())
@@ -314,25 +398,20 @@ void CosmeticFiltersJSHandler::OnShouldDoCosmeticFiltering(
 
 void CosmeticFiltersJSHandler::OnUrlCosmeticResources(
     base::OnceClosure callback,
-    base::Value result) {
-  resources_dict_ = base::DictionaryValue::From(
-      base::Value::ToUniquePtrValue(std::move(result)));
+    mojom::CosmeticResourcesPtr resources) {
+  resources_ = std::move(resources);
   std::move(callback).Run();
 }
 
 void CosmeticFiltersJSHandler::ApplyRules() {
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  if (!resources_dict_ || web_frame->IsProvisional())
+  if (!resources_ || web_frame->IsProvisional())
     return;
 
-  std::string scriptlet_script;
-  base::Value* injected_script = resources_dict_->FindPath("injected_script");
-  if (injected_script &&
-      base::JSONWriter::Write(*injected_script, &scriptlet_script)) {
-    scriptlet_script =
-        base::StringPrintf(kScriptletInitScript, scriptlet_script.c_str());
-  }
-  if (!scriptlet_script.empty()) {
+  if (!resources_->injected_script.empty()) {
+    std::string scriptlet_script = base::StringPrintf(
+        kScriptletInitScript,
+        base::GetQuotedJSONString(resources_->injected_script).c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(scriptlet_script),
         blink::BackForwardCacheAware::kAllow);
@@ -342,11 +421,9 @@ void CosmeticFiltersJSHandler::ApplyRules() {
     return;
 
   // Working on css rules, we do that on a main frame only
-  bool generichide = false;
-  resources_dict_->GetBoolean("generichide", &generichide);
   std::string cosmetic_filtering_init_script = base::StringPrintf(
       kCosmeticFilteringInitScript, enabled_1st_party_cf_ ? "true" : "false",
-      generichide ? "true" : "false");
+      resources_->generichide ? "true" : "false");
   std::string pre_init_script = base::StringPrintf(
       kPreInitScript, cosmetic_filtering_init_script.c_str());
 
@@ -357,77 +434,47 @@ void CosmeticFiltersJSHandler::ApplyRules() {
       isolated_world_id_, blink::WebString::FromUTF8(*g_observing_script),
       blink::BackForwardCacheAware::kAllow);
 
-  CSSRulesRoutine(resources_dict_.get());
+  CSSRulesRoutine(*resources_);
 }
 
 void CosmeticFiltersJSHandler::CSSRulesRoutine(
-    base::DictionaryValue* resources_dict) {
+    const mojom::CosmeticResources& resources) {
   // Otherwise, if its a vetted engine AND we're not in aggressive
   // mode, also don't do cosmetic filtering.
   if (!enabled_1st_party_cf_ && IsVettedSearchEngine(url_))
     return;
 
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  base::ListValue* cf_exceptions_list;
-  if (resources_dict->GetList("exceptions", &cf_exceptions_list)) {
-    for (size_t i = 0; i < cf_exceptions_list->GetSize(); i++) {
-      exceptions_.push_back(cf_exceptions_list->GetList()[i].GetString());
-    }
-  }
-  base::ListValue* hide_selectors_list;
-  if (!resources_dict->GetList("hide_selectors", &hide_selectors_list)) {
-    hide_selectors_list = nullptr;
-  }
-  base::ListValue* force_hide_selectors_list;
-  if (!resources_dict->GetList("force_hide_selectors",
-                               &force_hide_selectors_list)) {
-    force_hide_selectors_list = nullptr;
-  }
+  exceptions_.insert(exceptions_.end(), resources.exceptions.begin(),
+                     resources.exceptions.end());
 
-  if (hide_selectors_list && hide_selectors_list->GetSize() != 0) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*hide_selectors_list, &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
+  if (!resources.hide_selectors.empty()) {
     // Building a script for stylesheet modifications
-    std::string new_selectors_script =
-        base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
+    std::string new_selectors_script = base::StringPrintf(
+        kHideSelectorsInjectScript,
+        SelectorsToJSONArray(resources.hide_selectors).c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
         blink::BackForwardCacheAware::kAllow);
   }
 
-  if (force_hide_selectors_list && force_hide_selectors_list->GetSize() != 0) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*force_hide_selectors_list, &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
+  if (!resources.force_hide_selectors.empty()) {
     // Building a script for stylesheet modifications
     std::string new_selectors_script = base::StringPrintf(
-        kForceHideSelectorsInjectScript, json_selectors.c_str());
+        kForceHideSelectorsInjectScript,
+        SelectorsToJSONArray(resources.force_hide_selectors).c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
         blink::BackForwardCacheAware::kAllow);
   }
 
-  base::DictionaryValue* style_selectors_dictionary = nullptr;
-  if (resources_dict->GetDictionary("style_selectors",
-                                    &style_selectors_dictionary)) {
-    std::string json_selectors;
-    if (!base::JSONWriter::Write(*style_selectors_dictionary,
-                                 &json_selectors) ||
-        json_selectors.empty()) {
-      json_selectors = "[]";
-    }
-    std::string new_selectors_script =
-        base::StringPrintf(kStyleSelectorsInjectScript, json_selectors.c_str());
-    if (!json_selectors.empty()) {
-      web_frame->ExecuteScriptInIsolatedWorld(
-          isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
-          blink::BackForwardCacheAware::kAllow);
-    }
+  if (!resources.style_selectors.empty()) {
+    std::string new_selectors_script = base::StringPrintf(
+        kStyleSelectorsInjectScript,
+        StyleSelectorsToJSONObject(resources.style_selectors).c_str());
+    web_frame->ExecuteScriptInIsolatedWorld(
+        isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
+        blink::BackForwardCacheAware::kAllow);
   }
 
   if (!enabled_1st_party_cf_) {
@@ -437,29 +484,18 @@ void CosmeticFiltersJSHandler::CSSRulesRoutine(
   }
 }
 
-void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(base::Value result) {
+void CosmeticFiltersJSHandler::OnHiddenClassIdSelectors(
+    const std::vector<std::string>& selectors) {
   // If its a vetted engine AND we're not in aggressive
   // mode, don't do cosmetic filtering.
   if (!enabled_1st_party_cf_ && IsVettedSearchEngine(url_))
     return;
 
-  // We expect a List value from adblock service. That is
-  // an extra check to be sure that adblock file exist and gives us
-  // rules that we expect
-  base::ListValue* selectors_list;
-  if (!result.GetAsList(&selectors_list))
-    return;
-
   blink::WebLocalFrame* web_frame = render_frame_->GetWebFrame();
-  std::string json_selectors;
-  if (!base::JSONWriter::Write(*selectors_list, &json_selectors) ||
-      json_selectors.empty()) {
-    json_selectors = "[]";
-  }
-  // Building a script for stylesheet modifications
-  std::string new_selectors_script =
-      base::StringPrintf(kHideSelectorsInjectScript, json_selectors.c_str());
-  if (selectors_list->GetSize() != 0) {
+  if (!selectors.empty()) {
+    // Building a script for stylesheet modifications
+    std::string new_selectors_script = base::StringPrintf(
+        kHideSelectorsInjectScript, SelectorsToJSONArray(selectors).c_str());
     web_frame->ExecuteScriptInIsolatedWorld(
         isolated_world_id_, blink::WebString::FromUTF8(new_selectors_script),
         blink::BackForwardCacheAware::kAllow);
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "base/memory/weak_ptr.h"
@@ -51,15 +52,19 @@ class CosmeticFiltersJSHandler {
 
   void CreateWorkerObject(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
-  // A function to be called from JS
-  void HiddenClassIdSelectors(const std::string& input);
+  // A function to be called from JS. Names are queued and sent to the
+  // browser at most once per frame interval.
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids);
+  void FlushHiddenClassIdSelectors();
 
   void OnShouldDoCosmeticFiltering(base::OnceClosure callback,
                                    bool enabled,
                                    bool first_party_enabled);
-  void OnUrlCosmeticResources(base::OnceClosure callback, base::Value result);
-  void CSSRulesRoutine(base::DictionaryValue* resources_dict);
-  void OnHiddenClassIdSelectors(base::Value result);
+  void OnUrlCosmeticResources(base::OnceClosure callback,
+                              mojom::CosmeticResourcesPtr resources);
+  void CSSRulesRoutine(const mojom::CosmeticResources& resources);
+  void OnHiddenClassIdSelectors(const std::vector<std::string>& selectors);
 
   content::RenderFrame* render_frame_;
   mojo::Remote<cosmetic_filters::mojom::CosmeticFiltersResources>
@@ -68,7 +73,17 @@ class CosmeticFiltersJSHandler {
   bool enabled_1st_party_cf_;
   std::vector<std::string> exceptions_;
   GURL url_;
-  std::unique_ptr<base::DictionaryValue> resources_dict_;
+  mojom::CosmeticResourcesPtr resources_;
+  // Class names and ids already sent to the browser for the current document.
+  // The page script is re-run several times per document and loses its own
+  // bookkeeping each time, so this is the authoritative filter.
+  std::unordered_set<std::string> queried_classes_;
+  std::unordered_set<std::string> queried_ids_;
+  // Names waiting for the next flush. They are only marked as queried once
+  // the request has actually been sent.
+  std::unordered_set<std::string> pending_classes_;
+  std::unordered_set<std::string> pending_ids_;
+  bool flush_scheduled_ = false;
   base::WeakPtrFactory<CosmeticFiltersJSHandler> weak_ptr_factory_{this};
 };
 
@@ -99,12 +99,10 @@ const fetchNewClassIdRules = () => {
     (!notYetQueriedIds || notYetQueriedIds.length === 0)) {
     return
   }
-  // Callback to c++ renderer process
+  // Callback to c++ renderer process, which batches and dedupes the names
+  // before asking the browser.
   // @ts-ignore
-  cf_worker.hiddenClassIdSelectors(
-      JSON.stringify({
-        classes: notYetQueriedClasses, ids: notYetQueriedIds
-      }))
+  cf_worker.hiddenClassIdSelectors(notYetQueriedClasses, notYetQueriedIds)
   notYetQueriedClasses = []
   notYetQueriedIds = []
 }
@@ -0,0 +1,156 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/speedreader/speedreader_distiller.h"
+
+#include <algorithm>
+
+#include "base/metrics/histogram_macros.h"
+#include "brave/components/speedreader/rust/ffi/speedreader.h"
+
+namespace speedreader {
+
+namespace {
+
+// TODO(brave-browser/issues/10372): would be better to pass explicit signal
+// back from rewriter to indicate if content was found
+constexpr size_t kMinDistilledSize = 1024;
+
+class RewriterBackend : public SpeedreaderDistiller::Backend {
+ public:
+  explicit RewriterBackend(std::unique_ptr<Rewriter> rewriter)
+      : rewriter_(std::move(rewriter)) {}
+  ~RewriterBackend() override = default;
+
+  RewriterBackend(const RewriterBackend&) = delete;
+  RewriterBackend& operator=(const RewriterBackend&) = delete;
+
+  int Write(const char* chunk, size_t length) override {
+    return rewriter_->Write(chunk, length);
+  }
+
+  int End() override { return rewriter_->End(); }
+
+ private:
+  std::unique_ptr<Rewriter> rewriter_;
+};
+
+}  // namespace
+
+SpeedreaderDistiller::SpeedreaderDistiller(std::string stylesheet,
+                                           bool streaming,
+                                           DataCallback data_callback,
+                                           base::OnceClosure failed_callback)
+    : stylesheet_(std::move(stylesheet)),
+      streaming_(streaming),
+      data_callback_(std::move(data_callback)),
+      failed_callback_(std::move(failed_callback)) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+SpeedreaderDistiller::~SpeedreaderDistiller() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // The rewriter may still flush into the sink while it is destroyed.
+  backend_.reset();
+}
+
+// static
+void SpeedreaderDistiller::OnOutput(const char* data,
+                                    size_t length,
+                                    void* user_data) {
+  static_cast<SpeedreaderDistiller*>(user_data)->AddOutput(data, length);
+}
+
+// static
+std::unique_ptr<SpeedreaderDistiller::Backend>
+SpeedreaderDistiller::WrapRewriter(std::unique_ptr<Rewriter> rewriter) {
+  if (!rewriter)
+    return nullptr;
+  return std::make_unique<RewriterBackend>(std::move(rewriter));
+}
+
+void SpeedreaderDistiller::Write(std::string chunk) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!failed_ && backend_) {
+    const base::TimeTicks start = base::TimeTicks::Now();
+    // Error occurred
+    if (backend_->Write(chunk.data(), chunk.length()) != 0)
+      OnFailed();
+    distill_time_ += base::TimeTicks::Now() - start;
+    written_bytes_ += chunk.length();
+  }
+  // Output may have been committed to while writing, in which case the
+  // original body is no longer needed.
+  if (!committed_) {
+    if (input_.empty())
+      input_ = std::move(chunk);
+    else
+      input_.append(chunk);
+  }
+  UpdatePeakMemory();
+}
+
+void SpeedreaderDistiller::End() {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  if (!failed_ && backend_) {
+    const base::TimeTicks start = base::TimeTicks::Now();
+    if (backend_->End() != 0)
+      OnFailed();
+    distill_time_ += base::TimeTicks::Now() - start;
+  }
+  UpdatePeakMemory();
+  UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill", distill_time_);
+  UMA_HISTOGRAM_MEMORY_KB("Brave.Speedreader.DistillPeakMemory",
+                          peak_memory_ / 1024);
+
+  if (committed_) {
+    // A failure was already reported.
+    if (!failed_)
+      data_callback_.Run(std::move(output_), true);
+  } else if (failed_ || output_.length() < kMinDistilledSize) {
+    data_callback_.Run(std::move(input_), true);
+  } else {
+    data_callback_.Run(stylesheet_ + output_, true);
+  }
+  output_.clear();
+  input_.clear();
+}
+
+void SpeedreaderDistiller::AddOutput(const char* data, size_t length) {
+  output_.append(data, length);
+  UpdatePeakMemory();
+  if (!committed_) {
+    if (output_.length() < kMinDistilledSize)
+      return;
+    committed_ = true;
+    input_.clear();
+    input_.shrink_to_fit();
+    output_.insert(0, stylesheet_);
+  }
+  std::string output;
+  output.swap(output_);
+  data_callback_.Run(std::move(output), false);
+}
+
+void SpeedreaderDistiller::OnFailed() {
+  failed_ = true;
+  if (!committed_)
+    return;
+  // Part of the distilled page has been sent and the original body is gone,
+  // so the load fails instead of ending early as if it was complete.
+  if (failed_callback_)
+    std::move(failed_callback_).Run();
+}
+
+void SpeedreaderDistiller::UpdatePeakMemory() {
+  size_t memory = input_.capacity() + output_.capacity();
+  // Non-streaming rewriters keep their own copy of everything written to
+  // them until they are done. Their parse trees aren't visible from here.
+  if (!streaming_ && backend_)
+    memory += written_bytes_;
+  peak_memory_ = std::max(peak_memory_, memory);
+}
+
+}  // namespace speedreader
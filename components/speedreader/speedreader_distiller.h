@@ -0,0 +1,92 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLER_H_
+#define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLER_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/callback.h"
+#include "base/sequence_checker.h"
+#include "base/time/time.h"
+
+namespace speedreader {
+
+class Rewriter;
+
+// Feeds a page through a rewriter. Output is held back until there is enough
+// of it to tell that the page was distilled; until then the original body is
+// kept so that it can be sent instead.
+//
+// Lives on its own sequence, and runs its callbacks there.
+class SpeedreaderDistiller {
+ public:
+  // The calls made on a rewriter. Both return 0 on success.
+  class Backend {
+   public:
+    virtual ~Backend() = default;
+    virtual int Write(const char* chunk, size_t length) = 0;
+    virtual int End() = 0;
+  };
+
+  // Gets the next piece of either the distilled or the untouched body. |done|
+  // is set with the last one.
+  using DataCallback =
+      base::RepeatingCallback<void(std::string data, bool done)>;
+
+  // |failed_callback| is run if distilling fails after part of the output has
+  // been sent; nothing else is sent after that.
+  SpeedreaderDistiller(std::string stylesheet,
+                       bool streaming,
+                       DataCallback data_callback,
+                       base::OnceClosure failed_callback);
+  ~SpeedreaderDistiller();
+
+  SpeedreaderDistiller(const SpeedreaderDistiller&) = delete;
+  SpeedreaderDistiller& operator=(const SpeedreaderDistiller&) = delete;
+
+  // Output sink for a rewriter, with the distiller as |user_data|.
+  static void OnOutput(const char* data, size_t length, void* user_data);
+
+  static std::unique_ptr<Backend> WrapRewriter(
+      std::unique_ptr<Rewriter> rewriter);
+
+  // Must be set before anything is written.
+  void set_backend(std::unique_ptr<Backend> backend) {
+    backend_ = std::move(backend);
+  }
+
+  void Write(std::string chunk);
+  void End();
+
+ private:
+  void AddOutput(const char* data, size_t length);
+  void OnFailed();
+  void UpdatePeakMemory();
+
+  const std::string stylesheet_;
+  const bool streaming_;
+  DataCallback data_callback_;
+  base::OnceClosure failed_callback_;
+  std::unique_ptr<Backend> backend_;
+
+  // The original body, kept until the output is committed to.
+  std::string input_;
+  std::string output_;
+  bool committed_ = false;
+  bool failed_ = false;
+
+  base::TimeDelta distill_time_;
+  size_t written_bytes_ = 0;
+  size_t peak_memory_ = 0;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
+}  // namespace speedreader
+
+#endif  // BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_DISTILLER_H_
@@ -0,0 +1,180 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/test/bind.h"
+#include "base/test/metrics/histogram_tester.h"
+#include "brave/components/speedreader/speedreader_distiller.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace speedreader {
+
+namespace {
+
+constexpr char kStylesheet[] = "<style></style>";
+constexpr char kBody[] = "<html><body>original</body></html>";
+
+// Produces |output_on_write| bytes for every write and |output_on_end| bytes
+// when ended. Write number |fail_on_write|, counting from one, fails.
+class FakeBackend : public SpeedreaderDistiller::Backend {
+ public:
+  explicit FakeBackend(SpeedreaderDistiller* distiller)
+      : distiller_(distiller) {}
+  ~FakeBackend() override = default;
+
+  int Write(const char* chunk, size_t length) override {
+    writes++;
+    if (writes == fail_on_write)
+      return 1;
+    Output(output_on_write);
+    return 0;
+  }
+
+  int End() override {
+    Output(output_on_end);
+    return 0;
+  }
+
+  size_t output_on_write = 0;
+  size_t output_on_end = 0;
+  int fail_on_write = 0;
+  int writes = 0;
+
+ private:
+  void Output(size_t length) {
+    if (length == 0)
+      return;
+    const std::string output(length, 'x');
+    SpeedreaderDistiller::OnOutput(output.data(), output.length(),
+                                   distiller_);
+  }
+
+  SpeedreaderDistiller* distiller_;
+};
+
+}  // namespace
+
+class SpeedreaderDistillerTest : public testing::Test {
+ public:
+  SpeedreaderDistillerTest() = default;
+  ~SpeedreaderDistillerTest() override = default;
+  SpeedreaderDistillerTest(const SpeedreaderDistillerTest&) = delete;
+  SpeedreaderDistillerTest& operator=(const SpeedreaderDistillerTest&) =
+      delete;
+
+ protected:
+  void CreateDistiller(bool streaming) {
+    distiller_ = std::make_unique<SpeedreaderDistiller>(
+        kStylesheet, streaming,
+        base::BindLambdaForTesting([this](std::string data, bool done) {
+          sent_.append(data);
+          sends_++;
+          done_ = done;
+        }),
+        base::BindLambdaForTesting([this]() { failed_ = true; }));
+    auto backend = std::make_unique<FakeBackend>(distiller_.get());
+    backend_ = backend.get();
+    distiller_->set_backend(std::move(backend));
+  }
+
+  std::unique_ptr<SpeedreaderDistiller> distiller_;
+  FakeBackend* backend_ = nullptr;
+
+  std::string sent_;
+  int sends_ = 0;
+  bool done_ = false;
+  bool failed_ = false;
+};
+
+TEST_F(SpeedreaderDistillerTest, FallsBackToBodyWhenOutputIsSmall) {
+  CreateDistiller(true);
+  backend_->output_on_end = 1023;
+
+  distiller_->Write(kBody);
+  distiller_->End();
+
+  EXPECT_EQ(kBody, sent_);
+  EXPECT_EQ(1, sends_);
+  EXPECT_TRUE(done_);
+  EXPECT_FALSE(failed_);
+}
+
+TEST_F(SpeedreaderDistillerTest, StreamsOutputOnceCommitted) {
+  CreateDistiller(true);
+  backend_->output_on_write = 1024;
+
+  distiller_->Write(kBody);
+
+  EXPECT_EQ(kStylesheet + std::string(1024, 'x'), sent_);
+  EXPECT_FALSE(done_);
+
+  distiller_->Write(kBody);
+  distiller_->End();
+
+  EXPECT_EQ(kStylesheet + std::string(2048, 'x'), sent_);
+  EXPECT_TRUE(done_);
+  EXPECT_FALSE(failed_);
+}
+
+TEST_F(SpeedreaderDistillerTest, FallsBackToBodyWhenFailingBeforeCommit) {
+  CreateDistiller(true);
+  backend_->fail_on_write = 1;
+
+  distiller_->Write(kBody);
+  distiller_->End();
+
+  EXPECT_EQ(kBody, sent_);
+  EXPECT_TRUE(done_);
+  EXPECT_FALSE(failed_);
+}
+
+TEST_F(SpeedreaderDistillerTest, FailsWhenFailingAfterCommit) {
+  CreateDistiller(true);
+  backend_->output_on_write = 1024;
+  backend_->fail_on_write = 2;
+
+  distiller_->Write(kBody);
+  distiller_->Write(kBody);
+  distiller_->End();
+
+  // The original body is gone, so only the part already sent is left and
+  // nothing marks the load as done.
+  EXPECT_TRUE(failed_);
+  EXPECT_EQ(kStylesheet + std::string(1024, 'x'), sent_);
+  EXPECT_EQ(1, sends_);
+  EXPECT_FALSE(done_);
+}
+
+TEST_F(SpeedreaderDistillerTest, DistillsWholeBodyWithoutStreaming) {
+  base::HistogramTester histogram_tester;
+  CreateDistiller(false);
+  backend_->output_on_end = 2048;
+
+  distiller_->Write(kBody);
+  distiller_->End();
+
+  EXPECT_EQ(1, backend_->writes);
+  EXPECT_EQ(kStylesheet + std::string(2048, 'x'), sent_);
+  EXPECT_TRUE(done_);
+  histogram_tester.ExpectTotalCount("Brave.Speedreader.Distill", 1);
+  histogram_tester.ExpectTotalCount("Brave.Speedreader.DistillPeakMemory", 1);
+}
+
+TEST_F(SpeedreaderDistillerTest, FallsBackToBodyWithoutStreaming) {
+  CreateDistiller(false);
+  backend_->output_on_end = 100;
+
+  distiller_->Write(kBody);
+  distiller_->End();
+
+  EXPECT_EQ(kBody, sent_);
+  EXPECT_EQ(1, sends_);
+  EXPECT_TRUE(done_);
+}
+
+}  // namespace speedreader
@@ -116,10 +116,22 @@ std::unique_ptr<Rewriter> SpeedreaderRewriterService::MakeRewriter(
   return speedreader_->MakeRewriter(url.spec(), backend_);
 }
 
+std::unique_ptr<Rewriter> SpeedreaderRewriterService::MakeRewriter(
+    const GURL& url,
+    void (*output_sink)(const char*, size_t, void*),
+    void* output_sink_user_data) {
+  return speedreader_->MakeRewriter(url.spec(), backend_, output_sink,
+                                    output_sink_user_data);
+}
+
 const std::string& SpeedreaderRewriterService::GetContentStylesheet() {
   return content_stylesheet_;
 }
 
+bool SpeedreaderRewriterService::IsStreamingBackend() const {
+  return backend_ == RewriterType::RewriterStreaming;
+}
+
 void SpeedreaderRewriterService::OnLoadStylesheet(std::string stylesheet) {
   VLOG(2) << "Speedreader stylesheet loaded";
   content_stylesheet_ = stylesheet;
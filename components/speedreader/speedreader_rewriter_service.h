@@ -45,7 +45,16 @@ class SpeedreaderRewriterService : public SpeedreaderComponent::Observer {
   // The API
   bool IsWhitelisted(const GURL& url);
   std::unique_ptr<Rewriter> MakeRewriter(const GURL& url);
+  // The returned rewriter hands every chunk of output to |output_sink| as
+  // soon as it is produced instead of accumulating it.
+  std::unique_ptr<Rewriter> MakeRewriter(
+      const GURL& url,
+      void (*output_sink)(const char*, size_t, void*),
+      void* output_sink_user_data);
   const std::string& GetContentStylesheet();
+  // Whether rewriters produce output while input is still being written.
+  // Other backends only distill once the whole document has been written.
+  bool IsStreamingBackend() const;
 
  private:
   using GetDATFileDataResult =
@@ -10,10 +10,11 @@
 #include <utility>
 
 #include "base/bind.h"
+#include "base/bind_post_task.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/task/post_task.h"
 #include "base/task/thread_pool.h"
-#include "brave/components/speedreader/rust/ffi/speedreader.h"
+#include "base/time/time.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
 #include "mojo/public/cpp/bindings/self_owned_receiver.h"
@@ -70,6 +71,7 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       body_producer_watcher_(FROM_HERE,
                              mojo::SimpleWatcher::ArmingPolicy::MANUAL,
                              std::move(task_runner)),
+      distiller_(nullptr, base::OnTaskRunnerDeleter(nullptr)),
       rewriter_service_(rewriter_service) {}
 
 SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
@@ -123,6 +125,31 @@ void SpeedReaderURLLoader::OnStartLoadingResponseBody(
     mojo::ScopedDataPipeConsumerHandle body) {
   VLOG(2) << __func__ << " " << response_url_;
   state_ = State::kLoading;
+  if (!throttle_ || !rewriter_service_) {
+    Abort();
+    return;
+  }
+
+  body_start_time_ = base::TimeTicks::Now();
+  streaming_ = rewriter_service_->IsStreamingBackend();
+  distill_task_runner_ = base::ThreadPool::CreateSequencedTaskRunner(
+      {base::TaskPriority::USER_BLOCKING});
+  distiller_ = std::unique_ptr<SpeedreaderDistiller, base::OnTaskRunnerDeleter>(
+      new SpeedreaderDistiller(
+          rewriter_service_->GetContentStylesheet(), streaming_,
+          base::BindPostTask(
+              task_runner_,
+              base::BindRepeating(&SpeedReaderURLLoader::OnDistilledData,
+                                  weak_factory_.GetWeakPtr())),
+          base::BindPostTask(
+              task_runner_,
+              base::BindOnce(&SpeedReaderURLLoader::OnDistillFailed,
+                             weak_factory_.GetWeakPtr()))),
+      base::OnTaskRunnerDeleter(distill_task_runner_));
+  distiller_->set_backend(
+      SpeedreaderDistiller::WrapRewriter(rewriter_service_->MakeRewriter(
+          response_url_, &SpeedreaderDistiller::OnOutput, distiller_.get())));
+
   body_consumer_handle_ = std::move(body);
   body_consumer_watcher_.Watch(
       body_consumer_handle_.get(),
@@ -193,20 +220,47 @@ void SpeedReaderURLLoader::ResumeReadingBodyFromNet() {
 }
 
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
-  DCHECK_EQ(State::kLoading, state_);
+  DCHECK(state_ == State::kLoading || state_ == State::kSending);
+
+  // A streaming rewriter is fed every chunk as soon as it is read. Other
+  // rewriters can't do anything before the document is complete, so the body
+  // is collected here, as |buffered_body_| isn't used for output yet, and
+  // handed over in one piece.
+  size_t start_size = 0;
+  char* buffer;
+  if (streaming_) {
+    read_buffer_.resize(kReadBufferSize);
+    buffer = &read_buffer_[0];
+  } else {
+    start_size = buffered_body_.size();
+    buffered_body_.resize(start_size + kReadBufferSize);
+    buffer = &buffered_body_[start_size];
+  }
 
-  size_t start_size = buffered_body_.size();
   uint32_t read_bytes = kReadBufferSize;
-  buffered_body_.resize(start_size + read_bytes);
-  MojoResult result = body_consumer_handle_->ReadData(
-      &buffered_body_[0] + start_size, &read_bytes, MOJO_READ_DATA_FLAG_NONE);
+  MojoResult result = body_consumer_handle_->ReadData(buffer, &read_bytes,
+                                                      MOJO_READ_DATA_FLAG_NONE);
+  if (!streaming_) {
+    buffered_body_.resize(start_size +
+                          (result == MOJO_RESULT_OK ? read_bytes : 0));
+  }
   switch (result) {
     case MOJO_RESULT_OK:
       break;
     case MOJO_RESULT_FAILED_PRECONDITION:
       // Reading is finished.
-      buffered_body_.resize(start_size);
-      MaybeLaunchSpeedreader();
+      body_consumer_watcher_.Cancel();
+      body_consumer_handle_.reset();
+      if (!streaming_) {
+        distill_task_runner_->PostTask(
+            FROM_HERE, base::BindOnce(&SpeedreaderDistiller::Write,
+                                      base::Unretained(distiller_.get()),
+                                      std::move(buffered_body_)));
+        buffered_body_.clear();
+      }
+      distill_task_runner_->PostTask(
+          FROM_HERE, base::BindOnce(&SpeedreaderDistiller::End,
+                                    base::Unretained(distiller_.get())));
       return;
     case MOJO_RESULT_SHOULD_WAIT:
       body_consumer_watcher_.ArmOrNotify();
@@ -217,71 +271,61 @@ void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   }
 
   DCHECK_EQ(MOJO_RESULT_OK, result);
-  buffered_body_.resize(start_size + read_bytes);
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  if (streaming_) {
+    // |distiller_| is deleted on the same sequence after any pending writes.
+    distill_task_runner_->PostTask(
+        FROM_HERE,
+        base::BindOnce(&SpeedreaderDistiller::Write,
+                       base::Unretained(distiller_.get()),
+                       std::string(read_buffer_.data(), read_bytes)));
+  }
 
   body_consumer_watcher_.ArmOrNotify();
 }
 
 void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
   DCHECK_EQ(State::kSending, state_);
+  waiting_for_writable_ = false;
   if (bytes_remaining_in_buffer_ > 0) {
     SendReceivedBodyToClient();
-  } else {
+  } else if (distill_complete_) {
     CompleteSending();
   }
 }
 
-void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
-  DCHECK_EQ(State::kLoading, state_);
-  if (!throttle_ || !rewriter_service_) {
-    Abort();
+void SpeedReaderURLLoader::OnDistilledData(std::string data, bool done) {
+  if (state_ == State::kAborted)
     return;
+  distill_complete_ = done;
+  if (state_ == State::kLoading) {
+    StartSending();
+    if (state_ != State::kSending)
+      return;
   }
+  DCHECK_EQ(State::kSending, state_);
 
-  VLOG(2) << __func__ << " buffered body size = " << buffered_body_.size();
+  // Drop what was already written before appending the new output.
+  buffered_body_.erase(0, buffered_body_.size() - bytes_remaining_in_buffer_);
+  buffered_body_.append(data);
   bytes_remaining_in_buffer_ = buffered_body_.size();
 
+  if (waiting_for_writable_)
+    return;
   if (bytes_remaining_in_buffer_ > 0) {
-    // Offload heavy distilling to another thread.
-    base::ThreadPool::PostTaskAndReplyWithResult(
-        FROM_HERE, {base::TaskPriority::USER_BLOCKING},
-        base::BindOnce(
-            [](std::string data, std::unique_ptr<Rewriter> rewriter,
-               const std::string& stylesheet) -> auto {
-              SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
-              int written = rewriter->Write(data.c_str(), data.length());
-              // Error occurred
-              if (written != 0) {
-                return data;
-              }
-
-              rewriter->End();
-              const std::string& transformed = rewriter->GetOutput();
-
-              // TODO(brave-browser/issues/10372): would be better to pass
-              // explicit signal back from rewriter to indicate if content was
-              // found
-              if (transformed.length() < 1024) {
-                return data;
-              }
-
-              return stylesheet + transformed;
-            },
-            std::move(buffered_body_),
-            rewriter_service_->MakeRewriter(response_url_),
-            rewriter_service_->GetContentStylesheet()),
-        base::BindOnce(&SpeedReaderURLLoader::CompleteLoading,
-                       weak_factory_.GetWeakPtr()));
+    SendReceivedBodyToClient();
     return;
   }
-  CompleteLoading(std::move(buffered_body_));
+  if (distill_complete_)
+    CompleteSending();
+}
+
+void SpeedReaderURLLoader::OnDistillFailed() {
+  if (state_ == State::kAborted)
+    return;
+  Abort();
 }
 
-void SpeedReaderURLLoader::CompleteLoading(std::string body) {
+void SpeedReaderURLLoader::StartSending() {
   DCHECK_EQ(State::kLoading, state_);
   state_ = State::kSending;
 
@@ -290,8 +334,12 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
     return;
   }
 
-  buffered_body_ = std::move(body);
-  bytes_remaining_in_buffer_ = buffered_body_.size();
+  // Without a streaming rewriter nothing is sent before the whole body has
+  // been downloaded and distilled, which Brave.Speedreader.Distill covers.
+  if (streaming_) {
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.TimeToFirstByte",
+                        base::TimeTicks::Now() - body_start_time_);
+  }
 
   throttle_->Resume();
   mojo::ScopedDataPipeConsumerHandle body_to_send;
@@ -311,14 +359,6 @@ void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   // Send deferred message.
   destination_url_loader_client_->OnStartLoadingResponseBody(
       std::move(body_to_send));
-
-  DCHECK(bytes_remaining_in_buffer_);
-  if (bytes_remaining_in_buffer_) {
-    SendReceivedBodyToClient();
-    return;
-  }
-
-  CompleteSending();
 }
 
 void SpeedReaderURLLoader::CompleteSending() {
@@ -333,6 +373,8 @@ void SpeedReaderURLLoader::CompleteSending() {
   body_producer_watcher_.Cancel();
   body_consumer_handle_.reset();
   body_producer_handle_.reset();
+  buffered_body_.clear();
+  distiller_.reset();
 }
 
 void SpeedReaderURLLoader::SendReceivedBodyToClient() {
@@ -353,6 +395,7 @@ void SpeedReaderURLLoader::SendReceivedBodyToClient() {
       Abort();
       return;
     case MOJO_RESULT_SHOULD_WAIT:
+      waiting_for_writable_ = true;
       body_producer_watcher_.ArmOrNotify();
       return;
     default:
@@ -360,6 +403,7 @@ void SpeedReaderURLLoader::SendReceivedBodyToClient() {
       return;
   }
   bytes_remaining_in_buffer_ -= bytes_sent;
+  waiting_for_writable_ = true;
   body_producer_watcher_.ArmOrNotify();
 }
 
@@ -371,6 +415,7 @@ void SpeedReaderURLLoader::Abort() {
   source_url_loader_.reset();
   source_url_client_receiver_.reset();
   destination_url_loader_client_.reset();
+  distiller_.reset();
   // |this| should be removed since the owner will destroy |this| or the owner
   // has already been destroyed by some reason.
 }
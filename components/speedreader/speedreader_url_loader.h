@@ -13,7 +13,10 @@
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
 #include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "brave/components/speedreader/speedreader_distiller.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
 #include "mojo/public/cpp/bindings/receiver.h"
@@ -30,8 +33,14 @@ namespace speedreader {
 class SpeedReaderThrottle;
 class SpeedreaderRewriterService;
 
-// Loads the whole response body and tries to Speedreader-distill it.
-// Cargoculted from |`SniffingURLLoader|.
+// Streams the response body through a Speedreader rewriter and sends the
+// distilled page on. Cargoculted from |`SniffingURLLoader|.
+//
+// The rewriter lives on its own sequence. With the streaming backend it is fed
+// every chunk as soon as it is read from the source, so distilling overlaps
+// the download, and its output is forwarded to the destination as it is
+// produced. Other backends only distill once the whole body has been read, so
+// for them the body is buffered and distilled in one go.
 //
 // This loader has five states:
 // kWaitForBody: The initial state until the body is received (=
@@ -39,14 +48,14 @@ class SpeedreaderRewriterService;
 //               finished (= OnComplete() is called). When body is provided, the
 //               state is changed to kLoading. Otherwise the state goes to
 //               kCompleted.
-// kLoading: Receives the body from the source loader and distills the page.
-//            The received body is kept in this loader until distilling
-//            is finished. When all body has been received and distilling is
-//            done, this loader will dispatch queued messages like
-//            OnStartLoadingResponseBody() to the destination
-//            loader client, and then the state is changed to kSending.
-// kSending: Receives the body and sends it to the destination loader client.
-//           The state changes to kCompleted after all data is sent.
+// kLoading: Receives the body from the source loader and pumps it into the
+//           rewriter. Once the rewriter produces its first output, or falls
+//           back to the original body, this loader dispatches
+//           OnStartLoadingResponseBody() to the destination loader client, and
+//           then the state is changed to kSending.
+// kSending: Sends the output to the destination loader client while the rest
+//           of the body may still be read and distilled. The state changes to
+//           kCompleted after distilling has finished and all data is sent.
 // kCompleted: All data has been sent to the destination loader.
 // kAborted: Unexpected behavior happens. Watchers, pipes and the binding from
 //           the source loader to |this| are stopped. All incoming messages from
@@ -114,10 +123,13 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
 
   void OnBodyReadable(MojoResult);
   void OnBodyWritable(MojoResult);
-  void MaybeLaunchSpeedreader();
 
-  // Gets either distilled or untouched body.
-  void CompleteLoading(std::string body);
+  // Gets the next piece of either the distilled or the untouched body. |done|
+  // is set with the last one.
+  void OnDistilledData(std::string data, bool done);
+  // Called if distilling fails after part of the output has been sent.
+  void OnDistillFailed();
+  void StartSending();
   void CompleteSending();
   void SendReceivedBodyToClient();
 
@@ -140,9 +152,22 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   // Set if OnComplete() is called during distilling.
   absl::optional<network::URLLoaderCompletionStatus> complete_status_;
 
-  // Note that this could be replaced by a distilled version.
+  // Runs the rewriter on |distill_task_runner_|.
+  std::unique_ptr<SpeedreaderDistiller, base::OnTaskRunnerDeleter> distiller_;
+  scoped_refptr<base::SequencedTaskRunner> distill_task_runner_;
+  bool distill_complete_ = false;
+  // Whether the rewriter produces output before the whole body is written.
+  bool streaming_ = false;
+  base::TimeTicks body_start_time_;
+
+  // Reused for every read from the source when streaming.
+  std::string read_buffer_;
+  // Without streaming, the body read so far. Afterwards, output that is
+  // waiting to be written to the destination.
   std::string buffered_body_;
-  size_t bytes_remaining_in_buffer_;
+  size_t bytes_remaining_in_buffer_ = 0;
+  // Whether |body_producer_watcher_| is armed for the next write.
+  bool waiting_for_writable_ = false;
 
   mojo::ScopedDataPipeConsumerHandle body_consumer_handle_;
   mojo::ScopedDataPipeProducerHandle body_producer_handle_;
@@ -0,0 +1,49 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/test/base/perf_test_util.h"
+
+#include "base/check_op.h"
+#include "base/time/time.h"
+#include "base/timer/lap_timer.h"
+#include "testing/perf/perf_result_reporter.h"
+
+namespace brave {
+
+namespace {
+
+constexpr int kWarmupRuns = 2;
+constexpr base::TimeDelta kTimeLimit = base::TimeDelta::FromSeconds(2);
+constexpr int kTimeCheckInterval = 1;
+
+}  // namespace
+
+void RunPerfTest(const std::string& metric_prefix,
+                 const std::string& metric,
+                 const std::string& story,
+                 const base::RepeatingClosure& lap) {
+  RunPerfTest(metric_prefix, metric, story, 1, lap);
+}
+
+void RunPerfTest(const std::string& metric_prefix,
+                 const std::string& metric,
+                 const std::string& story,
+                 size_t iterations_per_lap,
+                 const base::RepeatingClosure& lap) {
+  DCHECK_GT(iterations_per_lap, 0u);
+
+  base::LapTimer timer(kWarmupRuns, kTimeLimit, kTimeCheckInterval);
+  do {
+    lap.Run();
+    timer.NextLap();
+  } while (!timer.HasTimeLimitExpired());
+
+  perf_test::PerfResultReporter reporter(metric_prefix, story);
+  reporter.RegisterImportantMetric(metric, "us");
+  reporter.AddResult(metric,
+                     timer.TimePerLap().InMicrosecondsF() / iterations_per_lap);
+}
+
+}  // namespace brave
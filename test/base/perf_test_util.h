@@ -0,0 +1,36 @@
+/* Copyright (c) 2021 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_TEST_BASE_PERF_TEST_UTIL_H_
+#define BRAVE_TEST_BASE_PERF_TEST_UTIL_H_
+
+#include <cstddef>
+#include <string>
+
+#include "base/callback.h"
+
+namespace brave {
+
+// Runs |lap| a couple of times untimed, then repeatedly for two seconds, and
+// reports the mean time per lap in microseconds as |metric| of |story|. The
+// clock is read after every lap, so laps should do at least a few
+// microseconds of work. Every Brave perf test uses the same settings so that
+// their results are comparable.
+void RunPerfTest(const std::string& metric_prefix,
+                 const std::string& metric,
+                 const std::string& story,
+                 const base::RepeatingClosure& lap);
+
+// As above, for laps that each do |iterations_per_lap| units of work. The
+// reported time is per unit.
+void RunPerfTest(const std::string& metric_prefix,
+                 const std::string& metric,
+                 const std::string& story,
+                 size_t iterations_per_lap,
+                 const base::RepeatingClosure& lap);
+
+}  // namespace brave
+
+#endif  // BRAVE_TEST_BASE_PERF_TEST_UTIL_H_